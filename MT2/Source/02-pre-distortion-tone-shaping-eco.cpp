@@ -0,0 +1,23 @@
+/**
+ * \file 02-pre-distortion-tone-shaping-eco.cpp
+ * Generated by schema/linearize.py from 02-pre-distortion-tone-shaping.cir, do not edit
+ */
+
+#include "LinearStateSpaceFilter.h"
+#include "static_elements.h"
+
+namespace MT2
+{
+std::unique_ptr<ATK::TypedBaseFilter<double>> createStaticFilter_stage2_eco()
+{
+  // Q010 linearized at Ic = 0.377 mA (gm = 14.51 mS, rpi = 6894 Ohm)
+  // States: C032, C034, C035
+  using Filter = LinearStateSpaceFilter<3>;
+  return std::make_unique<Filter>(Filter::Matrix{{{-45454.545454545456, 252199.02601488671, -4114014.2986756661},
+      {0, -934.07046672180275, 15237.089995095061},
+      {0, -2223.0586179996626, -2656.6906340522901}}},
+      Filter::Vector{{-252199.02601488671, 934.07046672180275, 2223.0586179996626}},
+      Filter::Vector{{-1, 0, 0}},
+      1);
+}
+} // namespace MT2
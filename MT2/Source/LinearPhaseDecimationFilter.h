@@ -0,0 +1,134 @@
+/**
+ * \file LinearPhaseDecimationFilter.h
+ */
+
+#ifndef LINEAR_PHASE_DECIMATION_FILTER
+#define LINEAR_PHASE_DECIMATION_FILTER
+
+#include <ATK/Core/TypedBaseFilter.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace MT2
+{
+/// Decimation filter with a linear phase lowpass, only computing the samples that are kept
+/**
+ * The lowpass is a Kaiser windowed sinc centered on the output Nyquist frequency, designed so that the passband is
+ * untouched and everything that folds back in the passband is attenuated by ATTENUATION dB. Its delay is exactly
+ * half its length, but it is longer than the IIR lowpass of the minimum phase path.
+ */
+class LinearPhaseDecimationFilter final: public ATK::TypedBaseFilter<double>
+{
+protected:
+  using Parent = ATK::TypedBaseFilter<double>;
+  using typename Parent::DataType;
+  using Parent::converted_inputs;
+  using Parent::input_delay;
+  using Parent::input_sampling_rate;
+  using Parent::nb_input_ports;
+  using Parent::output_sampling_rate;
+  using Parent::outputs;
+
+public:
+  /// Stopband attenuation of the lowpass, in dB
+  static constexpr double ATTENUATION = 90;
+
+  explicit LinearPhaseDecimationFilter(gsl::index nb_channels = 1)
+    : Parent(nb_channels, nb_channels)
+  {
+  }
+
+  ~LinearPhaseDecimationFilter() override = default;
+
+  /// Sets the highest frequency that has to be kept intact
+  void set_passband(DataType passband)
+  {
+    this->passband = passband;
+    setup();
+  }
+
+protected:
+  void setup() override
+  {
+    Parent::setup();
+    if(input_sampling_rate == 0 || output_sampling_rate == 0)
+    {
+      return;
+    }
+    decimation = input_sampling_rate / output_sampling_rate;
+
+    const DataType edge = std::min(passband, static_cast<DataType>(.45 * output_sampling_rate));
+    const DataType transition = (output_sampling_rate - 2 * edge) / input_sampling_rate;
+    const DataType cutoff = static_cast<DataType>(output_sampling_rate) / (2 * input_sampling_rate);
+    const DataType pi = std::acos(DataType(-1));
+
+    auto nb_coefficients
+        = static_cast<gsl::index>(std::ceil((ATTENUATION - 8) / (2.285 * 2 * pi * transition))) + 1;
+    nb_coefficients |= 1;
+    const DataType beta = 0.1102 * (ATTENUATION - 8.7);
+    const DataType middle = (nb_coefficients - 1) / 2.;
+
+    coefficients.assign(nb_coefficients, 0);
+    DataType sum = 0;
+    for(gsl::index i = 0; i < nb_coefficients; ++i)
+    {
+      const DataType x = i - middle;
+      const DataType sinc = x == 0 ? 2 * cutoff : std::sin(2 * pi * cutoff * x) / (pi * x);
+      const DataType ratio = x / middle;
+      coefficients[i] = sinc * bessel_i0(beta * std::sqrt(1 - ratio * ratio)) / bessel_i0(beta);
+      sum += coefficients[i];
+    }
+    for(auto& coefficient: coefficients)
+    {
+      coefficient /= sum;
+    }
+
+    input_delay = nb_coefficients - 1;
+  }
+
+  void process_impl(gsl::index size) const override
+  {
+    const auto nb_coefficients = static_cast<gsl::index>(coefficients.size());
+    const DataType* ATK_RESTRICT coefficients_ptr = coefficients.data();
+
+    for(gsl::index channel = 0; channel < nb_input_ports; ++channel)
+    {
+      const DataType* ATK_RESTRICT input = converted_inputs[channel];
+      DataType* ATK_RESTRICT output = outputs[channel];
+      for(gsl::index i = 0; i < size; ++i)
+      {
+        const DataType* ATK_RESTRICT current = input + i * decimation;
+        DataType sum = 0;
+        for(gsl::index j = 0; j < nb_coefficients; ++j)
+        {
+          sum += coefficients_ptr[j] * current[-j];
+        }
+        output[i] = sum;
+      }
+    }
+  }
+
+private:
+  /// Modified Bessel function of the first kind, used by the Kaiser window
+  static DataType bessel_i0(DataType x)
+  {
+    DataType sum = 1;
+    DataType term = 1;
+    for(int k = 1; term > 1e-12 * sum; ++k)
+    {
+      const DataType factor = x / (2 * k);
+      term *= factor * factor;
+      sum += term;
+    }
+    return sum;
+  }
+
+  DataType passband{20000};
+  gsl::index decimation{1};
+  std::vector<DataType> coefficients;
+};
+} // namespace MT2
+
+#endif
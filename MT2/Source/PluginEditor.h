@@ -16,6 +16,28 @@
 #include <ATKJUCEComponents/JUCE/ImageLookAndFeel.h>
 #include <ATKJUCEComponents/JUCE/Slider.h>
 
+#ifdef CHAIN_PROFILING
+/// Overlay showing the load and the Newton iterations of each stage of the chain
+class MT2ProfilingOverlay
+  : public juce::Component
+  , private juce::Timer
+{
+public:
+  explicit MT2ProfilingOverlay(const MT2AudioProcessor& processor);
+  ~MT2ProfilingOverlay();
+
+  void paint(juce::Graphics&) override;
+
+private:
+  /// Refresh rate of the overlay, in Hz
+  static constexpr int REFRESH_RATE = 4;
+
+  void timerCallback() override;
+
+  const MT2AudioProcessor& processor;
+};
+#endif
+
 //==============================================================================
 /**
  */
@@ -43,4 +65,7 @@ private:
   ATK::juce::SliderComponent highLevel;
   ATK::juce::SliderComponent midLevel;
   ATK::juce::SliderComponent midFreq;
+#ifdef CHAIN_PROFILING
+  MT2ProfilingOverlay profilingOverlay;
+#endif
 };
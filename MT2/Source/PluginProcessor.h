@@ -12,16 +12,21 @@
 
 #include "JuceHeader.h"
 
-#include <atk_core/atk_core.h>
-#include <atk_eq/atk_eq.h>
-#include <atk_tools/atk_tools.h>
+#include "ProcessingChain.h"
 
+#include <array>
+#include <atomic>
 #include <memory>
+#include <vector>
 
 //==============================================================================
 /**
  */
-class MT2AudioProcessor: public juce::AudioProcessor
+class MT2AudioProcessor
+  : public juce::AudioProcessor
+  , private juce::Thread
+  , private juce::AudioProcessorValueTreeState::Listener
+  , private juce::AsyncUpdater
 {
 public:
   //==============================================================================
@@ -37,6 +42,8 @@ public:
 #endif
 
   void processBlock(juce::AudioSampleBuffer&, juce::MidiBuffer&) override;
+  /// Passes the input through with the reported latency while the chain settles and goes idle
+  void processBlockBypassed(juce::AudioSampleBuffer&, juce::MidiBuffer&) override;
 
   //==============================================================================
   juce::AudioProcessorEditor* createEditor() override;
@@ -61,35 +68,102 @@ public:
   void getStateInformation(juce::MemoryBlock& destData) override;
   void setStateInformation(const void* data, int sizeInBytes) override;
 
+#ifdef CHAIN_PROFILING
+  //==============================================================================
+  /// Smoothed cost of a stage of the active chain, written by the audio thread and read by the editor
+  struct StageLoad
+  {
+    /// Share of the duration of the processed audio spent in the stage, in %
+    std::atomic<float> load{0};
+    /// Newton iterations per host sample
+    std::atomic<float> iterations{0};
+  };
+  using StageLoads = std::array<StageLoad, MT2::ProcessingChain::NB_STAGES>;
+
+  const StageLoads& getStageLoads() const;
+#endif
+
 private:
-  static constexpr int OVERSAMPLING = 8;
-
-  ATK::InPointerFilter<float> inFilter;
-  std::unique_ptr<ATK::ModellerFilter<double>> highPassFilter;
-  ATK::OversamplingFilter<double, ATK::Oversampling6points5order_8<double>> oversamplingFilter;
-  std::unique_ptr<ATK::ModellerFilter<double>> preDistortionToneShapingFilter;
-  std::unique_ptr<ATK::ModellerFilter<double>> bandPassFilter;
-  std::unique_ptr<ATK::ModellerFilter<double>> distLevelFilter;
-  std::unique_ptr<ATK::ModellerFilter<double>> distFilter;
-  std::unique_ptr<ATK::ModellerFilter<double>> postDistortionToneShapingFilter;
-  ATK::IIRFilter<ATK::ButterworthLowPassCoefficients<double>> lowpassFilter;
-  ATK::DecimationFilter<double> decimationFilter;
-  ATK::IIRFilter<ATK::ButterworthHighPassCoefficients<double>> DCFilter;
-  ATK::SecondOrderSVFFilter<ATK::SecondOrderSVFBellCoefficients<double>> lowToneControlFilter;
-  ATK::SecondOrderSVFFilter<ATK::SecondOrderSVFHighShelfCoefficients<double>> highToneControlFilter;
-  ATK::SecondOrderSVFFilter<ATK::SecondOrderSVFBellCoefficients<double>> sweepableMidToneControlFilter;
-  ATK::OutPointerFilter<float> outFilter;
+  /// Smallest maximum block size the chains are preallocated for
+  static constexpr int MAX_BLOCK_SIZE = 1024;
+  /// Length of the crossfade between the active and the standby chain
+  static constexpr int FADE_LENGTH = 512;
+  /// Polling period of the preparation thread, in ms
+  static constexpr int PREPARATION_POLLING = 20;
+  /// Number of input samples kept for the dry path and the warm up, a power of 2
+  static constexpr int HISTORY_LENGTH = 1024;
+  /// Number of recent input samples a chain processes before it is faded in, after a bypass or a reconfiguration
+  static constexpr int WARMUP_LENGTH = 256;
+
+  /// State of the standby chain, shared between the audio thread and the preparation thread
+  enum class ChainState
+  {
+    Stale, ///< the standby chain has to be configured by the preparation thread
+    Preparing, ///< the preparation thread is configuring the standby chain
+    Ready, ///< the standby chain can be faded in by the audio thread
+    Fading ///< the audio thread is fading the standby chain in
+  };
+
+  /// Prepares the standby chain in the background
+  void run() override;
+
+  /// Called when the resampling mode or the model changes, possibly from the audio thread
+  void parameterChanged(const juce::String& parameterID, float newValue) override;
+  /// Reconfigures the chains for the new resampling mode or model and reports the new latency
+  void handleAsyncUpdate() override;
+  /// Asks the preparation thread for a standby chain matching the requested configuration
+  void requestConfiguration();
+  /// Reports the latency of the requested configuration to the host
+  void updateLatency();
+
+  MT2::ProcessingChain::Parameters getChainParameters() const;
+  MT2::ProcessingChain::Resampling getResampling() const;
+  MT2::ProcessingChain::Model getModel() const;
+
+  using ParameterValues = std::array<float, 10>;
+  /// Returns the current values of all parameters, in the order of the handles
+  ParameterValues getParameterValues() const;
+  /// Sets all parameters through their handles, in the order of the chain parameters
+  void setParameterValues(const ParameterValues& values);
+
+  /// Stores input in the history and writes it delayed by the reported latency in dry, which can be input
+  void pushHistory(const float* input, float* dry, int size);
+  /// Runs the last WARMUP_LENGTH input samples through the chain so that it doesn't start from a stale state
+  void warmUp(MT2::ProcessingChain& chain);
+#ifdef CHAIN_PROFILING
+  /// Adds the profile of the last size samples processed by chain to the smoothed stage loads
+  void accountProfile(const MT2::ProcessingChain& chain, int size);
+#endif
+
+  std::array<std::unique_ptr<MT2::ProcessingChain>, 2> chains;
+  /// Generation of the configuration of each chain, written by the preparation thread and read by the audio thread
+  std::array<std::atomic<int>, 2> chainGenerations{{-1, -1}};
+  std::atomic<int> activeChain{0};
+  std::atomic<ChainState> standbyState{ChainState::Stale};
+  std::atomic<int> requestedGeneration{0};
+  std::atomic<long> requestedSampleRate{0};
+  std::atomic<int> requestedBlockSize{0};
+  std::atomic<MT2::ProcessingChain::Resampling> requestedResampling{MT2::ProcessingChain::Resampling::MinimumPhase};
+  std::atomic<MT2::ProcessingChain::Model> requestedModel{MT2::ProcessingChain::Model::Full};
+  std::vector<float> fadeBuffer;
+  int fadePosition{-1};
+  /// Set when a program was loaded, its parameters are faded in with the standby chain and not applied to the active one
+  std::atomic<bool> programChanged{false};
+
+  std::vector<float> history;
+  int historyPosition{0};
+  std::vector<float> dryBuffer;
+  bool bypassed{false};
+  /// Position in the fade from the dry signal to the chain output after a bypass, -1 when not fading
+  int bypassFadePosition{-1};
+#ifdef CHAIN_PROFILING
+  StageLoads stageLoads;
+#endif
+
+  /// Parameters in the order of the chain parameters, followed by the resampling mode and the model
+  std::array<juce::RangedAudioParameter*, 10> parameterHandles{};
 
   juce::AudioProcessorValueTreeState parameters;
   long sampleRate;
-  int lastParameterSet;
-
-  float old_distLevel{1000};
-  float old_lowLevel{100};
-  float old_highLevel{100};
-  float old_midLevel{100};
-  float old_midFreq{1};
-  float old_lowQ{0};
-  float old_highQ{0};
-  float old_midQ{0};
+  int lastParameterSet{0};
 };
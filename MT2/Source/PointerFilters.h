@@ -0,0 +1,116 @@
+/**
+ * \file PointerFilters.h
+ */
+
+#ifndef POINTER_FILTERS
+#define POINTER_FILTERS
+
+#include <ATK/Core/TypedBaseFilter.h>
+
+#include <algorithm>
+
+namespace MT2
+{
+/// Source filter converting a float host buffer straight into the double chain
+/**
+ * ATK::InPointerFilter<float> copies the host buffer in its own float output, and the first double stage then
+ * converts this output in its converted_inputs buffer. Here the conversion is done once, into the output of this
+ * filter, which the next stage reads directly as the types match.
+ */
+class FloatInPointerFilter final: public ATK::TypedBaseFilter<double>
+{
+protected:
+  using Parent = ATK::TypedBaseFilter<double>;
+  using typename Parent::DataType;
+  using Parent::outputs;
+
+public:
+  FloatInPointerFilter()
+    : Parent(0, 1)
+  {
+  }
+
+  ~FloatInPointerFilter() override = default;
+
+  /// Sets the host buffer to read from, resets the read position
+  void set_pointer(const float* array, gsl::index size)
+  {
+    this->array = array;
+    mysize = size;
+    offset = 0;
+  }
+
+protected:
+  void process_impl(gsl::index size) const override
+  {
+    const auto processed_size = std::max(gsl::index{0}, std::min(size, mysize - offset));
+    const float* ATK_RESTRICT input = array + offset;
+    DataType* ATK_RESTRICT output = outputs[0];
+
+    for(gsl::index i = 0; i < processed_size; ++i)
+    {
+      output[i] = static_cast<DataType>(input[i]);
+    }
+    for(gsl::index i = processed_size; i < size; ++i)
+    {
+      output[i] = 0;
+    }
+    offset += size;
+  }
+
+private:
+  const float* array{nullptr};
+  gsl::index mysize{0};
+  mutable gsl::index offset{0};
+};
+
+/// Sink filter converting the double chain output straight into a float host buffer
+/**
+ * The input of this filter has the type of the last stage, so its converted_inputs buffer is the output of that stage
+ * and the float conversion happens while writing the host buffer.
+ */
+class FloatOutPointerFilter final: public ATK::TypedBaseFilter<double>
+{
+protected:
+  using Parent = ATK::TypedBaseFilter<double>;
+  using typename Parent::DataType;
+  using Parent::converted_inputs;
+
+public:
+  FloatOutPointerFilter()
+    : Parent(1, 0)
+  {
+  }
+
+  ~FloatOutPointerFilter() override = default;
+
+  /// Sets the host buffer to write to, resets the write position
+  void set_pointer(float* array, gsl::index size)
+  {
+    this->array = array;
+    mysize = size;
+    offset = 0;
+  }
+
+protected:
+  void process_impl(gsl::index size) const override
+  {
+    const auto processed_size = std::max(gsl::index{0}, std::min(size, mysize - offset));
+    const DataType* ATK_RESTRICT input = converted_inputs[0];
+    float* ATK_RESTRICT output = array + offset;
+
+    for(gsl::index i = 0; i < processed_size; ++i)
+    {
+      output[i] = static_cast<float>(input[i]);
+    }
+    offset += size;
+  }
+
+private:
+  float* array{nullptr};
+  gsl::index mysize{0};
+  mutable gsl::index offset{0};
+};
+} // namespace MT2
+
+#endif
@@ -0,0 +1,86 @@
+/**
+ * \file ProfilingFilter.h
+ */
+
+#ifndef PROFILING_FILTER
+#define PROFILING_FILTER
+
+#include "Instrumentation.h"
+
+#include <ATK/Core/TypedBaseFilter.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+#ifndef STAGES_COUNT_ITERATIONS
+#error "CHAIN_PROFILING needs the stages to be built with STAGES_COUNT_ITERATIONS"
+#endif
+
+namespace MT2
+{
+/// Pass through filter recording when the filters before it are done
+/**
+ * The chain pulls its filters from the output, so each filter processes its block once all its inputs are done. With
+ * a probe after each stage, the time between two consecutive probes is the time of the stage between them. Each probe
+ * also records the Newton iterations of the stage it follows during the block.
+ */
+class ProfilingFilter final: public ATK::TypedBaseFilter<double>
+{
+protected:
+  using Parent = ATK::TypedBaseFilter<double>;
+  using typename Parent::DataType;
+  using Parent::converted_inputs;
+  using Parent::outputs;
+
+public:
+  using Clock = std::chrono::steady_clock;
+
+  ProfilingFilter()
+    : Parent(1, 1)
+  {
+  }
+
+  ~ProfilingFilter() override = default;
+
+  /// Returns when the last block went through the probe
+  Clock::time_point get_time() const
+  {
+    return time;
+  }
+
+  /// Sets the stage whose iterations are counted, the filters that don't iterate count none
+  void set_stage(const ATK::BaseFilter* stage)
+  {
+    counter = Stages::get_iteration_counter(stage);
+    total_iterations = counter ? counter->get_nb_iterations() : 0;
+  }
+
+  /// Returns the Newton iterations of the stage during the last block
+  std::int64_t get_iterations() const
+  {
+    return iterations;
+  }
+
+protected:
+  void process_impl(gsl::index size) const override
+  {
+    std::copy(converted_inputs[0], converted_inputs[0] + size, outputs[0]);
+    time = Clock::now();
+    if(counter)
+    {
+      const std::int64_t total = counter->get_nb_iterations();
+      iterations = total - total_iterations;
+      total_iterations = total;
+    }
+  }
+
+private:
+  const Stages::IterationCounter* counter{nullptr};
+  mutable Clock::time_point time;
+  mutable std::int64_t iterations{0};
+  mutable std::int64_t total_iterations{0};
+};
+} // namespace MT2
+
+#endif
@@ -0,0 +1,62 @@
+/**
+ * \file RampFilter.h
+ */
+
+#ifndef RAMP_FILTER
+#define RAMP_FILTER
+
+#include <ATK/Core/TypedBaseFilter.h>
+
+namespace MT2
+{
+/// Source filter turning a parameter set once per block into a per sample stream
+/**
+ * Each processed block goes linearly from the previous target to the current one, so that a parameter changed by the
+ * host at the block rate sweeps smoothly instead of stepping. The first target is reached immediately.
+ */
+class RampFilter final: public ATK::TypedBaseFilter<double>
+{
+protected:
+  using Parent = ATK::TypedBaseFilter<double>;
+  using typename Parent::DataType;
+  using Parent::outputs;
+
+public:
+  RampFilter()
+    : Parent(0, 1)
+  {
+  }
+
+  ~RampFilter() override = default;
+
+  /// Sets the value reached at the end of the next block
+  void set_target(DataType target)
+  {
+    if(!initialized)
+    {
+      current = target;
+      initialized = true;
+    }
+    this->target = target;
+  }
+
+protected:
+  void process_impl(gsl::index size) const override
+  {
+    DataType* ATK_RESTRICT output = outputs[0];
+    const DataType step = (target - current) / size;
+    for(gsl::index i = 0; i < size; ++i)
+    {
+      output[i] = current + step * (i + 1);
+    }
+    current = target;
+  }
+
+private:
+  mutable DataType current{0};
+  DataType target{0};
+  bool initialized{false};
+};
+} // namespace MT2
+
+#endif
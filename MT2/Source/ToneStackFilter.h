@@ -0,0 +1,274 @@
+/**
+ * \file ToneStackFilter.h
+ */
+
+#ifndef TONE_STACK_FILTER
+#define TONE_STACK_FILTER
+
+#include <ATK/Core/TypedBaseFilter.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace MT2
+{
+/// The DC blocker and the three tone control sections fused in a single pass
+/**
+ * The DC blocker is a second order Butterworth high pass, the sections are state variable filters (a bell for the low
+ * and mid controls, a high shelf for the high control) with the same coefficients as ATK::SecondOrderSVFFilter.
+ * The states are kept in locals for the whole block, and sections at unity gain, which are identities, are skipped
+ * and keep their state.
+ * Each channel is a lane with the same coefficients, the lane loop being the inner loop so that the compiler can
+ * vectorize it, ToneStackFilter<2> processes a stereo pair in one pass.
+ * With mid modulation, an additional last input port gives the mid frequency in Hz for each sample, and the mid
+ * coefficients are updated every sample with a rational approximation of the tan prewarping.
+ */
+template<int LANES = 1>
+class ToneStackFilter final: public ATK::TypedBaseFilter<double>
+{
+protected:
+  using Parent = ATK::TypedBaseFilter<double>;
+  using typename Parent::DataType;
+  using Parent::converted_inputs;
+  using Parent::input_sampling_rate;
+  using Parent::outputs;
+
+public:
+  /// The tone control sections, in processing order
+  enum Section
+  {
+    Low, ///< bell
+    High, ///< high shelf
+    Mid, ///< bell
+    NB_SECTIONS
+  };
+
+  explicit ToneStackFilter(bool mid_modulation = false)
+    : Parent(mid_modulation ? LANES + 1 : LANES, LANES)
+    , mid_modulation(mid_modulation)
+  {
+  }
+
+  ~ToneStackFilter() override = default;
+
+  /// Sets the cut frequency of the DC blocker
+  void set_dc_cut_frequency(DataType cut_frequency)
+  {
+    dc_cut_frequency = cut_frequency;
+    setup();
+  }
+
+  /// Sets the center frequency of a bell section or the cut frequency of the shelf section
+  /**
+   * With mid modulation, the frequency of the mid section comes from the modulation port instead.
+   */
+  void set_cut_frequency(Section section, DataType cut_frequency)
+  {
+    parameters[section].cut_frequency = cut_frequency;
+    setup();
+  }
+
+  /// Sets the Q of a section
+  void set_Q(Section section, DataType Q)
+  {
+    parameters[section].Q = Q;
+    setup();
+  }
+
+  /// Sets the linear gain of a section, a section with a gain of 1 is skipped
+  void set_gain(Section section, DataType gain)
+  {
+    parameters[section].gain = gain;
+    setup();
+  }
+
+  /// Sets all states to 0
+  void full_setup() override
+  {
+    Parent::full_setup();
+    dc_state = {};
+    section_states = {};
+  }
+
+protected:
+  void setup() override
+  {
+    Parent::setup();
+    if(input_sampling_rate == 0)
+    {
+      return;
+    }
+    const DataType pi = std::acos(DataType(-1));
+    pi_over_sampling_rate = pi / input_sampling_rate;
+
+    // Bilinear transform of the analog Butterworth high pass, prewarped at the cut frequency
+    const DataType K = std::tan(pi * dc_cut_frequency / input_sampling_rate);
+    const DataType norm = 1 / (1 + std::sqrt(DataType(2)) * K + K * K);
+    dc_b0 = norm;
+    dc_b1 = -2 * norm;
+    dc_b2 = norm;
+    dc_a1 = 2 * (K * K - 1) * norm;
+    dc_a2 = (1 - std::sqrt(DataType(2)) * K + K * K) * norm;
+
+    for(int section = 0; section < NB_SECTIONS; ++section)
+    {
+      const auto& parameter = parameters[section];
+      auto& coefficient = coefficients[section];
+      const DataType A = parameter.gain;
+      DataType g = std::tan(pi * parameter.cut_frequency / input_sampling_rate);
+      DataType k = 1 / parameter.Q;
+      if(section == High)
+      {
+        g *= std::sqrt(A);
+        coefficient.m0 = A * A;
+        coefficient.m1 = k * (1 - A) * A;
+        coefficient.m2 = 1 - A * A;
+      }
+      else
+      {
+        k /= A;
+        coefficient.m0 = 1;
+        coefficient.m1 = k * (A * A - 1);
+        coefficient.m2 = 0;
+      }
+      coefficient.k = k;
+      coefficient.a1 = 1 / (1 + g * (g + k));
+      coefficient.a2 = g * coefficient.a1;
+      coefficient.a3 = g * coefficient.a2;
+      coefficient.active = A != 1;
+    }
+  }
+
+  void process_impl(gsl::index size) const override
+  {
+    const DataType* ATK_RESTRICT inputs[LANES];
+    DataType* ATK_RESTRICT lane_outputs[LANES];
+    DataType dc0[LANES];
+    DataType dc1[LANES];
+    for(int lane = 0; lane < LANES; ++lane)
+    {
+      inputs[lane] = converted_inputs[lane];
+      lane_outputs[lane] = outputs[lane];
+      dc0[lane] = dc_state[lane][0];
+      dc1[lane] = dc_state[lane][1];
+    }
+    auto states = section_states;
+    const bool low = coefficients[Low].active;
+    const bool high = coefficients[High].active;
+    const bool mid = coefficients[Mid].active;
+    const DataType* ATK_RESTRICT mid_frequencies = mid_modulation ? converted_inputs[LANES] : nullptr;
+    // The frequency is kept below the Nyquist frequency, where the tan approximation is still accurate
+    const DataType max_x = static_cast<DataType>(.45) * std::acos(DataType(-1));
+    auto mid_coefficients = coefficients[Mid];
+
+    for(gsl::index i = 0; i < size; ++i)
+    {
+      DataType x[LANES];
+      for(int lane = 0; lane < LANES; ++lane)
+      {
+        // Transposed direct form II
+        const DataType input = inputs[lane][i];
+        const DataType output = dc_b0 * input + dc0[lane];
+        dc0[lane] = dc_b1 * input - dc_a1 * output + dc1[lane];
+        dc1[lane] = dc_b2 * input - dc_a2 * output;
+        x[lane] = output;
+      }
+      if(low)
+      {
+        process_section(coefficients[Low], states[Low], x);
+      }
+      if(high)
+      {
+        process_section(coefficients[High], states[High], x);
+      }
+      if(mid && mid_frequencies)
+      {
+        const DataType g = tan_prewarp(std::min(mid_frequencies[i] * pi_over_sampling_rate, max_x));
+        mid_coefficients.a1 = 1 / (1 + g * (g + mid_coefficients.k));
+        mid_coefficients.a2 = g * mid_coefficients.a1;
+        mid_coefficients.a3 = g * mid_coefficients.a2;
+        process_section(mid_coefficients, states[Mid], x);
+      }
+      else if(mid)
+      {
+        process_section(coefficients[Mid], states[Mid], x);
+      }
+      for(int lane = 0; lane < LANES; ++lane)
+      {
+        lane_outputs[lane][i] = x[lane];
+      }
+    }
+
+    for(int lane = 0; lane < LANES; ++lane)
+    {
+      dc_state[lane] = {{dc0[lane], dc1[lane]}};
+    }
+    section_states = states;
+  }
+
+private:
+  struct SectionParameters
+  {
+    DataType cut_frequency{1000};
+    DataType Q{1};
+    DataType gain{1};
+  };
+
+  struct SectionCoefficients
+  {
+    DataType k{1};
+    DataType a1{0};
+    DataType a2{0};
+    DataType a3{0};
+    DataType m0{1};
+    DataType m1{0};
+    DataType m2{0};
+    bool active{false};
+  };
+
+  /// The two integrator states of a section for each lane
+  struct SectionState
+  {
+    std::array<DataType, LANES> ic1eq{};
+    std::array<DataType, LANES> ic2eq{};
+  };
+
+  /// (5, 4) Pade approximant of tan, relative error below 1e-10 up to .15 pi and 3e-5 up to .45 pi
+  static DataType tan_prewarp(DataType x)
+  {
+    const DataType x2 = x * x;
+    return x * (945 - 105 * x2 + x2 * x2) / (945 - 420 * x2 + 15 * x2 * x2);
+  }
+
+  static void process_section(const SectionCoefficients& coefficient, SectionState& state, DataType* x)
+  {
+    for(int lane = 0; lane < LANES; ++lane)
+    {
+      const DataType v3 = x[lane] - state.ic2eq[lane];
+      const DataType v1 = coefficient.a1 * state.ic1eq[lane] + coefficient.a2 * v3;
+      const DataType v2 = state.ic2eq[lane] + coefficient.a2 * state.ic1eq[lane] + coefficient.a3 * v3;
+      state.ic1eq[lane] = 2 * v1 - state.ic1eq[lane];
+      state.ic2eq[lane] = 2 * v2 - state.ic2eq[lane];
+      x[lane] = coefficient.m0 * x[lane] + coefficient.m1 * v1 + coefficient.m2 * v2;
+    }
+  }
+
+  const bool mid_modulation;
+  DataType pi_over_sampling_rate{0};
+
+  DataType dc_cut_frequency{1};
+  DataType dc_b0{1};
+  DataType dc_b1{0};
+  DataType dc_b2{0};
+  DataType dc_a1{0};
+  DataType dc_a2{0};
+  mutable std::array<std::array<DataType, 2>, LANES> dc_state{};
+
+  std::array<SectionParameters, NB_SECTIONS> parameters;
+  std::array<SectionCoefficients, NB_SECTIONS> coefficients;
+  mutable std::array<SectionState, NB_SECTIONS> section_states{};
+};
+} // namespace MT2
+
+#endif
@@ -18,6 +18,10 @@ std::unique_ptr<ATK::ModellerFilter<double>> createStaticFilter_stage4();
 std::unique_ptr<ATK::ModellerFilter<double>> createStaticFilter_stage5();
 std::unique_ptr<ATK::ModellerFilter<double>> createStaticFilter_stage6();
 std::unique_ptr<ATK::ModellerFilter<double>> createStaticFilter_stage7();
+
+/// Linear state spaces of stages 2 and 6 with their transistors at the operating point, generated by schema/linearize.py
+std::unique_ptr<ATK::TypedBaseFilter<double>> createStaticFilter_stage2_eco();
+std::unique_ptr<ATK::TypedBaseFilter<double>> createStaticFilter_stage6_eco();
 } // namespace MT2
 
 #endif
@@ -0,0 +1,23 @@
+/**
+ * \file 02-pre-distortion-tone-shaping-eco.cpp
+ * Generated by schema/linearize.py from 02-pre-distortion-tone-shaping.cir, do not edit
+ */
+
+#include "LinearStateSpaceFilter.h"
+#include "static_elements.h"
+
+namespace MTB
+{
+std::unique_ptr<ATK::TypedBaseFilter<double>> createStaticFilter_stage2_eco()
+{
+  // Q010 linearized at Ic = 0.374 mA (gm = 14.38 mS, rpi = 6952 Ohm)
+  // States: C032, C034, C035
+  using Filter = LinearStateSpaceFilter<3>;
+  return std::make_unique<Filter>(Filter::Matrix{{{-454545.45454545453, 202600.13477157149, -1873934.5328876995},
+      {0, -460.45485175357163, 4258.9421201993173},
+      {0, -1882.6376055058879, -2088.8574348497168}}},
+      Filter::Vector{{-202600.13477157149, 460.45485175357163, 1882.6376055058879}},
+      Filter::Vector{{-1, 0, 0}},
+      1);
+}
+} // namespace MTB
@@ -0,0 +1,26 @@
+/**
+ * \file 06-post-distortion-tone-shaping-eco.cpp
+ * Generated by schema/linearize.py from 06-post-distortion-tone-shaping.cir, do not edit
+ */
+
+#include "LinearStateSpaceFilter.h"
+#include "static_elements.h"
+
+namespace MTB
+{
+std::unique_ptr<ATK::TypedBaseFilter<double>> createStaticFilter_stage6_eco()
+{
+  // Q007 linearized at Ic = 0.270 mA (gm = 10.38 mS, rpi = 9631 Ohm)
+  // Q008 linearized at Ic = 0.377 mA (gm = 14.51 mS, rpi = 6894 Ohm)
+  // States: C022, C020, C017, C024, C025
+  using Filter = LinearStateSpaceFilter<5>;
+  return std::make_unique<Filter>(Filter::Matrix{{{-6447453.2559638945, 418699.06130075443, -36905340.636902995, 778920.9538508968, -44256882.723642886},
+      {0, -89.449344914252094, 7884.3227724292765, 0, 0},
+      {0, -62.644305570510539, -432.32415498016604, 0, 0},
+      {0, 0, 0, -244.061898873281, 13867.156586741437},
+      {0, 0, 0, -3159.6388755352355, -6162.7688186273963}}},
+      Filter::Vector{{-1197620.0151516511, 89.449344914252094, 62.644305570510539, 244.061898873281, 3159.6388755352355}},
+      Filter::Vector{{-1, 0, 0, 0, 0}},
+      1);
+}
+} // namespace MTB
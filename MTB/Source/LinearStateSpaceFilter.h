@@ -0,0 +1,109 @@
+/**
+ * \file LinearStateSpaceFilter.h
+ */
+
+#ifndef LINEAR_STATE_SPACE_FILTER
+#define LINEAR_STATE_SPACE_FILTER
+
+#include <ATK/Core/TypedBaseFilter.h>
+
+#include <Eigen/Dense>
+
+#include <array>
+
+namespace MTB
+{
+/// Single input, single output filter defined by a continuous state space dx/dt = A x + B u, y = C x + D u
+/**
+ * The state space is discretized with the trapezoidal rule at the input sampling rate, the same integration as the
+ * capacitors of the ModellerFilter stages, so a linear netlist gives the same output with both filters, without any
+ * Newton iteration.
+ */
+template<int STATES>
+class LinearStateSpaceFilter final: public ATK::TypedBaseFilter<double>
+{
+protected:
+  using Parent = ATK::TypedBaseFilter<double>;
+  using typename Parent::DataType;
+  using Parent::converted_inputs;
+  using Parent::input_sampling_rate;
+  using Parent::outputs;
+
+public:
+  using Matrix = std::array<std::array<DataType, STATES>, STATES>;
+  using Vector = std::array<DataType, STATES>;
+
+  LinearStateSpaceFilter(const Matrix& A, const Vector& B, const Vector& C, DataType D)
+    : Parent(1, 1)
+    , D(D)
+  {
+    for(int i = 0; i < STATES; ++i)
+    {
+      for(int j = 0; j < STATES; ++j)
+      {
+        this->A(i, j) = A[i][j];
+      }
+      this->B(i) = B[i];
+      this->C(i) = C[i];
+    }
+  }
+
+  ~LinearStateSpaceFilter() override = default;
+
+  /// Sets the state and the previous input to 0
+  void full_setup() override
+  {
+    Parent::full_setup();
+    state.setZero();
+    previous_input = 0;
+  }
+
+protected:
+  using StateMatrix = Eigen::Matrix<DataType, STATES, STATES>;
+  using StateVector = Eigen::Matrix<DataType, STATES, 1>;
+
+  void setup() override
+  {
+    Parent::setup();
+    if(input_sampling_rate == 0)
+    {
+      return;
+    }
+    // x[n] = x[n-1] + T/2 (A (x[n] + x[n-1]) + B (u[n] + u[n-1]))
+    const DataType half_step = 1. / (2 * input_sampling_rate);
+    const StateMatrix identity = StateMatrix::Identity();
+    const StateMatrix inverse = (identity - half_step * A).inverse();
+    Ad = inverse * (identity + half_step * A);
+    Bd = inverse * B * half_step;
+  }
+
+  void process_impl(gsl::index size) const override
+  {
+    const DataType* ATK_RESTRICT input = converted_inputs[0];
+    DataType* ATK_RESTRICT output = outputs[0];
+    StateVector x = state;
+    DataType previous = previous_input;
+    for(gsl::index i = 0; i < size; ++i)
+    {
+      x = Ad * x + Bd * (input[i] + previous);
+      previous = input[i];
+      output[i] = C.dot(x) + D * input[i];
+    }
+    state = x;
+    previous_input = previous;
+  }
+
+private:
+  StateMatrix A;
+  StateVector B;
+  StateVector C;
+  const DataType D;
+
+  StateMatrix Ad{StateMatrix::Identity()};
+  StateVector Bd{StateVector::Zero()};
+  mutable StateVector state{StateVector::Zero()};
+  mutable DataType previous_input{0};
+};
+} // namespace MTB
+
+#endif
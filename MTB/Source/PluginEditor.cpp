@@ -11,6 +11,55 @@
 #include "PluginEditor.h"
 #include "PluginProcessor.h"
 
+#ifdef CHAIN_PROFILING
+//==============================================================================
+MTBProfilingOverlay::MTBProfilingOverlay(const MTBAudioProcessor& processor)
+  : processor(processor)
+{
+  setInterceptsMouseClicks(false, false);
+  startTimerHz(REFRESH_RATE);
+}
+
+MTBProfilingOverlay::~MTBProfilingOverlay()
+{
+  stopTimer();
+}
+
+void MTBProfilingOverlay::paint(juce::Graphics& g)
+{
+  const auto& stageLoads = processor.getStageLoads();
+  const int lineHeight = getHeight() / static_cast<int>(stageLoads.size() + 1);
+  g.fillAll(juce::Colours::black.withAlpha(.6f));
+  g.setFont(juce::Font(10.0f));
+  g.setColour(juce::Colours::whitesmoke);
+
+  float total = 0;
+  for(std::size_t i = 0; i < stageLoads.size(); ++i)
+  {
+    const float load = stageLoads[i].load.load(std::memory_order_relaxed);
+    const float iterations = stageLoads[i].iterations.load(std::memory_order_relaxed);
+    total += load;
+    const int y = static_cast<int>(i) * lineHeight;
+    g.drawText(MTB::ProcessingChain::getStageName(static_cast<MTB::ProcessingChain::Stage>(i)),
+        4,
+        y,
+        90,
+        lineHeight,
+        juce::Justification::centredLeft);
+    g.drawText(juce::String(load, 2) + " %", 94, y, 50, lineHeight, juce::Justification::centredRight);
+    g.drawText(juce::String(iterations, 2) + " it", 144, y, 50, lineHeight, juce::Justification::centredRight);
+  }
+  const int y = static_cast<int>(stageLoads.size()) * lineHeight;
+  g.drawText("Total", 4, y, 90, lineHeight, juce::Justification::centredLeft);
+  g.drawText(juce::String(total, 2) + " %", 94, y, 50, lineHeight, juce::Justification::centredRight);
+}
+
+void MTBProfilingOverlay::timerCallback()
+{
+  repaint();
+}
+#endif
+
 //==============================================================================
 MTBAudioProcessorEditor::MTBAudioProcessorEditor(MTBAudioProcessor& p, juce::AudioProcessorValueTreeState& paramState)
   : AudioProcessorEditor(&p)
@@ -22,13 +71,18 @@ MTBAudioProcessorEditor::MTBAudioProcessorEditor(MTBAudioProcessor& p, juce::Aud
   , highLevel(paramState, "highLevel", "High Level", &knob)
   , midLevel(paramState, "midLevel", "Mid Level", &knob)
   , midFreq(paramState, "midFreq", "Mid Freq", &knob)
-
+#ifdef CHAIN_PROFILING
+  , profilingOverlay(p)
+#endif
 {
   addAndMakeVisible(distLevel);
   addAndMakeVisible(lowLevel);
   addAndMakeVisible(highLevel);
   addAndMakeVisible(midLevel);
   addAndMakeVisible(midFreq);
+#ifdef CHAIN_PROFILING
+  addAndMakeVisible(profilingOverlay);
+#endif
 
   bckgndImage = juce::ImageFileFormat::loadFrom(BinaryData::background_jpg, BinaryData::background_jpgSize);
 
@@ -63,4 +117,7 @@ void MTBAudioProcessorEditor::resized()
   highLevel.setBounds(120, 120, 55, 55);
   midLevel.setBounds(220, 40, 55, 55);
   midFreq.setBounds(220, 120, 55, 55);
+#ifdef CHAIN_PROFILING
+  profilingOverlay.setBounds(getLocalBounds().removeFromRight(200));
+#endif
 }
@@ -16,6 +16,28 @@
 #include <ATKJUCEComponents/JUCE/ImageLookAndFeel.h>
 #include <ATKJUCEComponents/JUCE/Slider.h>
 
+#ifdef CHAIN_PROFILING
+/// Overlay showing the load and the Newton iterations of each stage of the chain
+class MTBProfilingOverlay
+  : public juce::Component
+  , private juce::Timer
+{
+public:
+  explicit MTBProfilingOverlay(const MTBAudioProcessor& processor);
+  ~MTBProfilingOverlay() override;
+
+  void paint(juce::Graphics&) override;
+
+private:
+  /// Refresh rate of the overlay, in Hz
+  static constexpr int REFRESH_RATE = 4;
+
+  void timerCallback() override;
+
+  const MTBAudioProcessor& processor;
+};
+#endif
+
 //==============================================================================
 /**
  */
@@ -43,6 +65,9 @@ private:
   ATK::juce::SliderComponent highLevel;
   ATK::juce::SliderComponent midLevel;
   ATK::juce::SliderComponent midFreq;
+#ifdef CHAIN_PROFILING
+  MTBProfilingOverlay profilingOverlay;
+#endif
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MTBAudioProcessorEditor)
 };
@@ -8,7 +8,39 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
-#include "static_elements.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+/// Parameter identifiers, in the order of MTB::ProcessingChain::Parameters, followed by the resampling mode and the model
+constexpr std::array<const char*, 10> parameterIds{
+    {"distLevel", "lowLevel", "highLevel", "midLevel", "midFreq", "lowQ", "highQ", "midQ", "resampling", "model"}};
+
+/// A factory program, with a value for each chain parameter, the resampling mode and the model are left as they are
+struct Program
+{
+  const char* name;
+  std::array<float, 8> values;
+};
+
+constexpr std::array<Program, 2> programs{{
+    {"Minimum distortion", {{0.f, 0.f, 0.f, 0.f, 500.f, 3.1f, .25f, 1.f}}},
+    {"Maximum damage", {{100.f, 20.f, 20.f, 15.f, 500.f, 3.1f, .25f, 1.f}}},
+}};
+
+/// Identifies the binary state format, "MTBS" read as a little endian integer
+constexpr int stateMagic = 0x5342544d;
+/// Version of the binary state, version 0 was the XML state
+/**
+ * The version is bumped whenever the layout of the values changes.
+ * Version 1 only stored the chain parameters, version 2 added the resampling mode and the model.
+ */
+constexpr int stateVersion = 2;
+/// Number of values stored by each version of the binary state
+constexpr std::array<int, stateVersion + 1> stateNbValues{{0, 8, 10}};
+} // namespace
 
 //==============================================================================
 MTBAudioProcessor::MTBAudioProcessor()
@@ -24,21 +56,8 @@ MTBAudioProcessor::MTBAudioProcessor()
           )
   ,
 #endif
-  inFilter(nullptr, 1, 0, false)
-  , highPassFilter(MTB::createStaticFilter_stage1())
-  , oversamplingFilter(1)
-  , preDistortionToneShapingFilter(MTB::createStaticFilter_stage2())
-  , bandPassFilter(MTB::createStaticFilter_stage3())
-  , distLevelFilter(MTB::createStaticFilter_stage4())
-  , distFilter(MTB::createStaticFilter_stage5())
-  , postDistortionToneShapingFilter(MTB::createStaticFilter_stage6())
-  , lowpassFilter(1)
-  , decimationFilter(1)
-  , DCFilter(1)
-  , lowToneControlFilter(1)
-  , highToneControlFilter(1)
-  , sweepableMidToneControlFilter(1)
-  , outFilter(nullptr, 1, 0, false)
+  juce::Thread("MTB chain preparation")
+  , chains{{std::make_unique<MTB::ProcessingChain>(), std::make_unique<MTB::ProcessingChain>()}}
   , parameters(*this,
         nullptr,
         juce::Identifier("ATKMTB"),
@@ -49,38 +68,25 @@ MTBAudioProcessor::MTBAudioProcessor()
             std::make_unique<juce::AudioParameterFloat>("midFreq", "Mid Freq", 100.f, 1500.f, 500.f),
             std::make_unique<juce::AudioParameterFloat>("lowQ", "Low Q", 1.f, 4.f, 3.1f),
             std::make_unique<juce::AudioParameterFloat>("highQ", "High Q", .1f, .5f, 0.25f),
-            std::make_unique<juce::AudioParameterFloat>("midQ", "MidQ", 0.5f, 4.f, 1.f)})
-{
-  highPassFilter->set_input_port(highPassFilter->find_input_pin("vin"), &inFilter, 0);
-  oversamplingFilter.set_input_port(0, highPassFilter.get(), highPassFilter->find_dynamic_pin("vout"));
-  preDistortionToneShapingFilter->set_input_port(
-      preDistortionToneShapingFilter->find_input_pin("vin"), &oversamplingFilter, 0);
-  bandPassFilter->set_input_port(bandPassFilter->find_input_pin("vin"),
-      preDistortionToneShapingFilter.get(),
-      preDistortionToneShapingFilter->find_dynamic_pin("vout"));
-  distLevelFilter->set_input_port(
-      distLevelFilter->find_input_pin("vin"), bandPassFilter.get(), bandPassFilter->find_dynamic_pin("vout"));
-  distFilter->set_input_port(
-      distFilter->find_input_pin("vin"), distLevelFilter.get(), distLevelFilter->find_dynamic_pin("vout"));
-  postDistortionToneShapingFilter->set_input_port(
-      postDistortionToneShapingFilter->find_input_pin("vin"), distFilter.get(), distFilter->find_dynamic_pin("vout"));
-  lowpassFilter.set_input_port(
-      0, postDistortionToneShapingFilter.get(), postDistortionToneShapingFilter->find_dynamic_pin("vout"));
-  decimationFilter.set_input_port(0, &lowpassFilter, 0);
-  DCFilter.set_input_port(0, &decimationFilter, 0);
-  lowToneControlFilter.set_input_port(0, &DCFilter, 0);
-  highToneControlFilter.set_input_port(0, &lowToneControlFilter, 0);
-  sweepableMidToneControlFilter.set_input_port(0, &highToneControlFilter, 0);
-  outFilter.set_input_port(0, &sweepableMidToneControlFilter, 0);
-
-  lowpassFilter.set_cut_frequency(20000);
-  lowpassFilter.set_order(6);
-  DCFilter.set_cut_frequency(1);
-  DCFilter.set_order(2);
+            std::make_unique<juce::AudioParameterFloat>("midQ", "MidQ", 0.5f, 4.f, 1.f),
+            std::make_unique<juce::AudioParameterChoice>(
+                "resampling", "Resampling", juce::StringArray{"Minimum phase", "Linear phase"}, 0),
+            std::make_unique<juce::AudioParameterChoice>("model", "Model", juce::StringArray{"Full", "Eco"}, 0)})
+{
+  for(std::size_t i = 0; i < parameterIds.size(); ++i)
+  {
+    parameterHandles[i] = parameters.getParameter(parameterIds[i]);
+  }
+  parameters.addParameterListener("resampling", this);
+  parameters.addParameterListener("model", this);
 }
 
 MTBAudioProcessor::~MTBAudioProcessor()
 {
+  parameters.removeParameterListener("resampling", this);
+  parameters.removeParameterListener("model", this);
+  cancelPendingUpdate();
+  stopThread(1000);
 }
 
 //==============================================================================
@@ -118,12 +124,13 @@ bool MTBAudioProcessor::isMidiEffect() const
 
 double MTBAudioProcessor::getTailLengthSeconds() const
 {
-  return 0.0;
+  // The chain keeps running until its input and output stayed silent this long
+  return MTB::ProcessingChain::IDLE_HOLD;
 }
 
 int MTBAudioProcessor::getNumPrograms()
 {
-  return 2;
+  return static_cast<int>(programs.size());
 }
 
 int MTBAudioProcessor::getCurrentProgram()
@@ -133,41 +140,27 @@ int MTBAudioProcessor::getCurrentProgram()
 
 void MTBAudioProcessor::setCurrentProgram(int index)
 {
-  if(index != lastParameterSet)
+  if(index != lastParameterSet && index >= 0 && index < getNumPrograms())
   {
     lastParameterSet = index;
-    if(index == 0)
-    {
-      const char* preset0
-          = "<MTB><PARAM id=\"distLevel\" value=\"0\" /><PARAM id=\"lowLevel\" value=\"0\" /><PARAM id=\"highLevel\" "
-            "value=\"0\" /> <PARAM id=\"midLevel\" value=\"0\" /><PARAM id=\"midFreq\" value=\"500\" /></MTB>";
-      juce::XmlDocument doc(preset0);
-
-      auto el = doc.getDocumentElement();
-      parameters.state = juce::ValueTree::fromXml(*el);
-    }
-    else if(index == 1)
+    // A program only holds the chain parameters, the resampling filters and the model are left as they are
+    const auto& values = programs[index].values;
+    for(std::size_t i = 0; i < values.size(); ++i)
     {
-      const char* preset1 = "<MTB><PARAM id=\"distLevel\" value=\"100\" /><PARAM id=\"lowLevel\" value=\"20\" /><PARAM "
-                            "id=\"highLevel\" value=\"20\" /> <PARAM id=\"midLevel\" value=\"15\" /><PARAM "
-                            "id=\"midFreq\" value=\"500\" /></MTB>";
-      juce::XmlDocument doc(preset1);
-
-      auto el = doc.getDocumentElement();
-      parameters.state = juce::ValueTree::fromXml(*el);
+      auto* parameter = parameterHandles[i];
+      parameter->beginChangeGesture();
+      parameter->setValueNotifyingHost(parameter->convertTo0to1(values[i]));
+      parameter->endChangeGesture();
     }
+    programChanged = true;
   }
 }
 
 const juce::String MTBAudioProcessor::getProgramName(int index)
 {
-  if(index == 0)
-  {
-    return "Minimum distortion";
-  }
-  if(index == 0)
+  if(index >= 0 && index < getNumPrograms())
   {
-    return "Maximum damage";
+    return programs[index].name;
   }
   return {};
 }
@@ -180,44 +173,130 @@ void MTBAudioProcessor::changeProgramName(int index, const juce::String& newName
 void MTBAudioProcessor::prepareToPlay(double dbSampleRate, int samplesPerBlock)
 {
   sampleRate = std::lround(dbSampleRate);
+  const int maxBlockSize = std::max(samplesPerBlock, MAX_BLOCK_SIZE);
+  fadeBuffer.resize(maxBlockSize);
+  dryBuffer.resize(maxBlockSize);
+  history.resize(HISTORY_LENGTH);
+
+  auto& active = *chains[activeChain];
+  const auto resampling = getResampling();
+  const auto model = getModel();
+  const bool activeUpToDate = active.getSampleRate() == sampleRate && active.getMaxBlockSize() >= samplesPerBlock
+                           && active.getResampling() == resampling && active.getModel() == model;
+  if(activeUpToDate && chainGenerations[activeChain] == requestedGeneration)
+  {
+    return;
+  }
+
+  requestedSampleRate = sampleRate;
+  requestedBlockSize = activeUpToDate ? active.getMaxBlockSize() : maxBlockSize;
+  requestedResampling = resampling;
+  requestedModel = model;
+  const int generation = ++requestedGeneration;
+  updateLatency();
+
+  if(active.getSampleRate() == 0)
+  {
+    // Nothing is playing yet, the first chain is configured right away
+    active.configure(sampleRate, maxBlockSize, resampling, model);
+    active.setParameters(getChainParameters());
+    chainGenerations[activeChain] = generation;
+  }
+  else if(activeUpToDate)
+  {
+    // Back to the configuration of the active chain, only the standby chain needs to follow
+    chainGenerations[activeChain] = generation;
+  }
+
+  // A pending fade or a ready standby chain are now outdated
+  fadePosition = -1;
+  auto expected = ChainState::Fading;
+  standbyState.compare_exchange_strong(expected, ChainState::Stale);
+  expected = ChainState::Ready;
+  standbyState.compare_exchange_strong(expected, ChainState::Stale);
+
+  startThread();
+  notify();
+}
+
+void MTBAudioProcessor::run()
+{
+  while(!threadShouldExit())
+  {
+    auto expected = ChainState::Stale;
+    if(standbyState.compare_exchange_strong(expected, ChainState::Preparing))
+    {
+      const int standby = 1 - activeChain;
+      const int generation = requestedGeneration;
+      if(chainGenerations[standby] != generation)
+      {
+        chains[standby]->configure(requestedSampleRate, requestedBlockSize, requestedResampling, requestedModel);
+        chainGenerations[standby] = generation;
+      }
+      chains[standby]->setParameters(getChainParameters());
+      standbyState = generation == requestedGeneration ? ChainState::Ready : ChainState::Stale;
+      continue;
+    }
+    wait(PREPARATION_POLLING);
+  }
+}
+
+void MTBAudioProcessor::parameterChanged(const juce::String& parameterID, float newValue)
+{
+  // The chains are reconfigured and the latency reported from the message thread
+  triggerAsyncUpdate();
+}
 
-  if(sampleRate != inFilter.get_output_sampling_rate())
+void MTBAudioProcessor::handleAsyncUpdate()
+{
+  const auto resampling = getResampling();
+  const auto model = getModel();
+  if(requestedSampleRate == 0 || (resampling == requestedResampling && model == requestedModel))
   {
-    inFilter.set_input_sampling_rate(sampleRate);
-    inFilter.set_output_sampling_rate(sampleRate);
-    highPassFilter->set_input_sampling_rate(sampleRate);
-    highPassFilter->set_output_sampling_rate(sampleRate);
-    oversamplingFilter.set_input_sampling_rate(sampleRate);
-    oversamplingFilter.set_output_sampling_rate(sampleRate * OVERSAMPLING);
-    preDistortionToneShapingFilter->set_input_sampling_rate(sampleRate * OVERSAMPLING);
-    preDistortionToneShapingFilter->set_output_sampling_rate(sampleRate * OVERSAMPLING);
-    bandPassFilter->set_input_sampling_rate(sampleRate * OVERSAMPLING);
-    bandPassFilter->set_output_sampling_rate(sampleRate * OVERSAMPLING);
-    distLevelFilter->set_input_sampling_rate(sampleRate * OVERSAMPLING);
-    distLevelFilter->set_output_sampling_rate(sampleRate * OVERSAMPLING);
-    distFilter->set_input_sampling_rate(sampleRate * OVERSAMPLING);
-    distFilter->set_output_sampling_rate(sampleRate * OVERSAMPLING);
-    postDistortionToneShapingFilter->set_input_sampling_rate(sampleRate * OVERSAMPLING);
-    postDistortionToneShapingFilter->set_output_sampling_rate(sampleRate * OVERSAMPLING);
-    lowpassFilter.set_input_sampling_rate(sampleRate * OVERSAMPLING);
-    lowpassFilter.set_output_sampling_rate(sampleRate * OVERSAMPLING);
-    decimationFilter.set_input_sampling_rate(sampleRate * OVERSAMPLING);
-    decimationFilter.set_output_sampling_rate(sampleRate);
-    DCFilter.set_input_sampling_rate(sampleRate);
-    DCFilter.set_output_sampling_rate(sampleRate);
-    lowToneControlFilter.set_input_sampling_rate(sampleRate);
-    lowToneControlFilter.set_output_sampling_rate(sampleRate);
-    highToneControlFilter.set_input_sampling_rate(sampleRate);
-    highToneControlFilter.set_output_sampling_rate(sampleRate);
-    sweepableMidToneControlFilter.set_input_sampling_rate(sampleRate);
-    sweepableMidToneControlFilter.set_output_sampling_rate(sampleRate);
-    outFilter.set_input_sampling_rate(sampleRate);
-    outFilter.set_output_sampling_rate(sampleRate);
-
-    lowToneControlFilter.set_cut_frequency(50);
-    highToneControlFilter.set_cut_frequency(2500);
+    return;
   }
-  outFilter.dryrun(samplesPerBlock);
+  requestedResampling = resampling;
+  requestedModel = model;
+  requestConfiguration();
+  updateLatency();
+}
+
+void MTBAudioProcessor::requestConfiguration()
+{
+  ++requestedGeneration;
+  // A standby chain that is already fading in is replaced once the fade is over
+  auto expected = ChainState::Ready;
+  standbyState.compare_exchange_strong(expected, ChainState::Stale);
+  notify();
+}
+
+void MTBAudioProcessor::updateLatency()
+{
+  setLatencySamples(static_cast<int>(
+      std::lround(MTB::ProcessingChain::computeResamplingLatency(requestedSampleRate, requestedResampling))));
+}
+
+MTB::ProcessingChain::Resampling MTBAudioProcessor::getResampling() const
+{
+  return static_cast<MTB::ProcessingChain::Resampling>(
+      static_cast<int>(*parameters.getRawParameterValue("resampling")));
+}
+
+MTB::ProcessingChain::Model MTBAudioProcessor::getModel() const
+{
+  return static_cast<MTB::ProcessingChain::Model>(static_cast<int>(*parameters.getRawParameterValue("model")));
+}
+
+MTB::ProcessingChain::Parameters MTBAudioProcessor::getChainParameters() const
+{
+  return {*parameters.getRawParameterValue("distLevel"),
+      *parameters.getRawParameterValue("lowLevel"),
+      *parameters.getRawParameterValue("highLevel"),
+      *parameters.getRawParameterValue("midLevel"),
+      *parameters.getRawParameterValue("midFreq"),
+      *parameters.getRawParameterValue("lowQ"),
+      *parameters.getRawParameterValue("highQ"),
+      *parameters.getRawParameterValue("midQ")};
 }
 
 void MTBAudioProcessor::releaseResources()
@@ -254,58 +333,185 @@ bool MTBAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 
 void MTBAudioProcessor::processBlock(juce::AudioSampleBuffer& buffer, juce::MidiBuffer& midiMessages)
 {
-  if(*parameters.getRawParameterValue("distLevel") != old_distLevel)
+  const int totalNumInputChannels = getTotalNumInputChannels();
+  const int totalNumOutputChannels = getTotalNumOutputChannels();
+
+  assert(totalNumInputChannels == totalNumOutputChannels);
+  assert(totalNumOutputChannels == 1);
+
+  const auto chainParameters = getChainParameters();
+  int active = activeChain;
+  int standby = 1 - active;
+
+  // The standby chain is claimed in one step, so that the preparation thread can't take it back in between
+  auto ready = ChainState::Ready;
+  if(fadePosition < 0 && (programChanged || chainGenerations[standby] != chainGenerations[active])
+      && standbyState.compare_exchange_strong(ready, ChainState::Fading))
   {
-    old_distLevel = *parameters.getRawParameterValue("distLevel");
-    distLevelFilter->set_parameter(0, old_distLevel * .99 / 100 + .05);
+    // The standby chain was prepared for a new configuration, or a new program has to be faded in
+    // A program change that comes while the standby chain is not ready waits for it, with the previous parameters
+    programChanged = false;
+    fadePosition = 0;
+    // The standby chain still has the state it had when it was last active, it catches up on the recent input
+    chains[standby]->setParameters(chainParameters);
+    warmUp(*chains[standby]);
   }
-  if(*parameters.getRawParameterValue("lowLevel") != old_lowLevel)
+
+  if(bypassed)
   {
-    old_lowLevel = *parameters.getRawParameterValue("lowLevel");
-    lowToneControlFilter.set_gain(std::pow(10, old_lowLevel / 40));
+    // Back from bypass, the settled chain is warmed up and faded in over the dry signal
+    bypassed = false;
+    bypassFadePosition = 0;
+    chains[active]->setParameters(chainParameters);
+    warmUp(*chains[active]);
   }
-  if(*parameters.getRawParameterValue("highLevel") != old_highLevel)
+
+  float* data = buffer.getWritePointer(0);
+  const int size = buffer.getNumSamples();
+
+  // Blocks bigger than the preallocated size are split so that ATK never allocates
+  for(int offset = 0; offset < size;)
   {
-    old_highLevel = *parameters.getRawParameterValue("highLevel");
-    highToneControlFilter.set_gain(std::pow(10, old_highLevel / 40));
+    float* slice = data + offset;
+    int sliceSize = std::min({size - offset, chains[active]->getMaxBlockSize(), static_cast<int>(dryBuffer.size())});
+    if(fadePosition >= 0)
+    {
+      sliceSize = std::min(sliceSize, chains[standby]->getMaxBlockSize());
+    }
+    pushHistory(slice, dryBuffer.data(), sliceSize);
+
+    if(fadePosition < 0)
+    {
+      // A new program is held back until the standby chain fades it in, the active chain keeps the previous one
+      if(!programChanged)
+      {
+        chains[active]->setParameters(chainParameters);
+      }
+      chains[active]->process(slice, slice, sliceSize);
+#ifdef CHAIN_PROFILING
+      accountProfile(*chains[active], sliceSize);
+#endif
+    }
+    else
+    {
+      // The active chain keeps its parameters while the standby chain fades in with the new ones
+      chains[standby]->setParameters(chainParameters);
+      chains[standby]->process(slice, fadeBuffer.data(), sliceSize);
+      chains[active]->process(slice, slice, sliceSize);
+#ifdef CHAIN_PROFILING
+      // Only the chain being faded out is accounted, the loads don't double during the crossfade
+      accountProfile(*chains[active], sliceSize);
+#endif
+      for(int i = 0; i < sliceSize; ++i)
+      {
+        const float gain = std::min(1.f, static_cast<float>(fadePosition + i + 1) / FADE_LENGTH);
+        slice[i] += gain * (fadeBuffer[i] - slice[i]);
+      }
+      fadePosition += sliceSize;
+
+      if(fadePosition >= FADE_LENGTH)
+      {
+        // The old chain becomes the standby one, and will be brought up to date by the preparation thread
+        fadePosition = -1;
+        std::swap(active, standby);
+        activeChain = active;
+        standbyState = ChainState::Stale;
+      }
+    }
+
+    if(bypassFadePosition >= 0)
+    {
+      for(int i = 0; i < sliceSize; ++i)
+      {
+        const float gain = std::min(1.f, static_cast<float>(bypassFadePosition + i + 1) / FADE_LENGTH);
+        slice[i] = dryBuffer[i] + gain * (slice[i] - dryBuffer[i]);
+      }
+      bypassFadePosition += sliceSize;
+      if(bypassFadePosition >= FADE_LENGTH)
+      {
+        bypassFadePosition = -1;
+      }
+    }
+    offset += sliceSize;
   }
-  if(*parameters.getRawParameterValue("midLevel") != old_midLevel)
+}
+
+void MTBAudioProcessor::processBlockBypassed(juce::AudioSampleBuffer& buffer, juce::MidiBuffer& midiMessages)
+{
+  if(fadePosition >= 0)
   {
-    old_midLevel = *parameters.getRawParameterValue("midLevel");
-    sweepableMidToneControlFilter.set_gain(std::pow(10, old_midLevel / 40));
+    // A crossfade between the chains is completed at once, the output is the dry signal anyway
+    fadePosition = -1;
+    activeChain = 1 - activeChain;
+    standbyState = ChainState::Stale;
   }
-  if(*parameters.getRawParameterValue("midFreq") != old_midFreq)
+  // While bypassed, the chain doesn't follow the input, it is warmed up on the recent input when it comes back
+  auto& chain = *chains[activeChain];
+  bypassed = true;
+  bypassFadePosition = -1;
+
+  float* data = buffer.getWritePointer(0);
+  const int size = buffer.getNumSamples();
+
+  for(int offset = 0; offset < size;)
   {
-    old_midFreq = *parameters.getRawParameterValue("midFreq");
-    sweepableMidToneControlFilter.set_cut_frequency(old_midFreq);
+    const int sliceSize = std::min({size - offset, chain.getMaxBlockSize(), static_cast<int>(fadeBuffer.size())});
+    // The chain decays on silence to its rest point, after IDLE_HOLD it is idle and costs a silence check
+    std::fill(fadeBuffer.begin(), fadeBuffer.begin() + sliceSize, 0.f);
+    chain.process(fadeBuffer.data(), fadeBuffer.data(), sliceSize);
+    pushHistory(data + offset, data + offset, sliceSize);
+    offset += sliceSize;
   }
-  if(*parameters.getRawParameterValue("lowQ") != old_lowQ)
+}
+
+void MTBAudioProcessor::pushHistory(const float* input, float* dry, int size)
+{
+  const int mask = HISTORY_LENGTH - 1;
+  const int latency = std::min(getLatencySamples(), mask);
+  for(int i = 0; i < size; ++i)
   {
-    old_lowQ = *parameters.getRawParameterValue("lowQ");
-    lowToneControlFilter.set_Q(old_lowQ);
+    history[historyPosition] = input[i];
+    dry[i] = history[(historyPosition - latency) & mask];
+    historyPosition = (historyPosition + 1) & mask;
   }
-  if(*parameters.getRawParameterValue("highQ") != old_highQ)
+}
+
+void MTBAudioProcessor::warmUp(MTB::ProcessingChain& chain)
+{
+  const int mask = HISTORY_LENGTH - 1;
+  const int size = std::min({WARMUP_LENGTH, chain.getMaxBlockSize(), static_cast<int>(fadeBuffer.size())});
+  for(int i = 0; i < size; ++i)
   {
-    old_highQ = *parameters.getRawParameterValue("highQ");
-    highToneControlFilter.set_Q(old_highQ);
+    fadeBuffer[i] = history[(historyPosition - size + i) & mask];
   }
-  if(*parameters.getRawParameterValue("midQ") != old_midQ)
+  chain.process(fadeBuffer.data(), fadeBuffer.data(), size);
+}
+
+#ifdef CHAIN_PROFILING
+void MTBAudioProcessor::accountProfile(const MTB::ProcessingChain& chain, int size)
+{
+  constexpr float smoothing = .1f;
+  const auto& profile = chain.getProfile();
+  const double duration = static_cast<double>(size) / sampleRate;
+  for(std::size_t i = 0; i < stageLoads.size(); ++i)
   {
-    old_midQ = *parameters.getRawParameterValue("midQ");
-    sweepableMidToneControlFilter.set_Q(old_midQ);
+    // Only the audio thread writes the loads, the editor may read them at any time
+    auto& stageLoad = stageLoads[i];
+    const auto load = static_cast<float>(100 * profile.seconds[i] / duration);
+    const auto iterations = static_cast<float>(profile.iterations[i]) / size;
+    stageLoad.load.store(stageLoad.load.load(std::memory_order_relaxed) * (1 - smoothing) + load * smoothing,
+        std::memory_order_relaxed);
+    stageLoad.iterations.store(
+        stageLoad.iterations.load(std::memory_order_relaxed) * (1 - smoothing) + iterations * smoothing,
+        std::memory_order_relaxed);
   }
+}
 
-  const int totalNumInputChannels = getTotalNumInputChannels();
-  const int totalNumOutputChannels = getTotalNumOutputChannels();
-
-  assert(totalNumInputChannels == totalNumOutputChannels);
-  assert(totalNumOutputChannels == 1);
-
-  inFilter.set_pointer(buffer.getReadPointer(0), buffer.getNumSamples());
-  outFilter.set_pointer(buffer.getWritePointer(0), buffer.getNumSamples());
-
-  outFilter.process(buffer.getNumSamples());
+const MTBAudioProcessor::StageLoads& MTBAudioProcessor::getStageLoads() const
+{
+  return stageLoads;
 }
+#endif
 
 //==============================================================================
 bool MTBAudioProcessor::hasEditor() const
@@ -319,16 +525,82 @@ juce::AudioProcessorEditor* MTBAudioProcessor::createEditor()
 }
 
 //==============================================================================
+MTBAudioProcessor::ParameterValues MTBAudioProcessor::getParameterValues() const
+{
+  ParameterValues values;
+  for(std::size_t i = 0; i < parameterHandles.size(); ++i)
+  {
+    values[i] = parameterHandles[i]->convertFrom0to1(parameterHandles[i]->getValue());
+  }
+  return values;
+}
+
+void MTBAudioProcessor::setParameterValues(const ParameterValues& values)
+{
+  for(std::size_t i = 0; i < parameterHandles.size(); ++i)
+  {
+    parameterHandles[i]->setValueNotifyingHost(parameterHandles[i]->convertTo0to1(values[i]));
+  }
+}
+
 void MTBAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-  auto state = parameters.copyState();
-  std::unique_ptr<juce::XmlElement> xml(state.createXml());
-  xml->setAttribute("version", "0");
-  copyXmlToBinary(*xml, destData);
+  static_assert(stateNbValues[stateVersion] == std::tuple_size<ParameterValues>::value,
+      "The state version has to be bumped when parameters are added");
+  juce::MemoryOutputStream stream(destData, false);
+  stream.writeInt(stateMagic);
+  stream.writeInt(stateVersion);
+  stream.writeInt(lastParameterSet);
+  stream.writeInt(static_cast<int>(parameterHandles.size()));
+  for(auto* parameter: parameterHandles)
+  {
+    stream.writeFloat(parameter->convertFrom0to1(parameter->getValue()));
+  }
 }
 
 void MTBAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
+  juce::MemoryInputStream stream(data, static_cast<std::size_t>(sizeInBytes), false);
+  if(sizeInBytes >= 4 * static_cast<int>(sizeof(int)) && stream.readInt() == stateMagic)
+  {
+    // States from newer versions of the plugin can't be interpreted and are ignored
+    const int version = stream.readInt();
+    if(version < 1 || version > stateVersion)
+    {
+      return;
+    }
+    const int program = stream.readInt();
+    const int nbValues = stream.readInt();
+    if(nbValues != stateNbValues[version])
+    {
+      return;
+    }
+
+    // The parameters older versions didn't store take their default values
+    ParameterValues values;
+    for(std::size_t i = 0; i < values.size(); ++i)
+    {
+      values[i] = parameterHandles[i]->convertFrom0to1(parameterHandles[i]->getDefaultValue());
+    }
+    for(int i = 0; i < nbValues; ++i)
+    {
+      if(stream.getNumBytesRemaining() < static_cast<juce::int64>(sizeof(float)))
+      {
+        return;
+      }
+      values[i] = stream.readFloat();
+    }
+
+    // The program index comes from the host, an unknown one keeps the current program
+    if(program >= 0 && program < getNumPrograms())
+    {
+      lastParameterSet = program;
+    }
+    setParameterValues(values);
+    return;
+  }
+
+  // Version 0 states were stored as XML
   std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
 
   if(xmlState.get() != nullptr)
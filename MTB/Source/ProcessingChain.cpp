@@ -0,0 +1,429 @@
+/**
+ * \file ProcessingChain.cpp
+ */
+
+#include "ProcessingChain.h"
+#include "static_elements.h"
+
+#include <ATK/Core/InPointerFilter.h>
+#include <ATK/Core/OutPointerFilter.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace
+{
+bool isSilent(const float* buffer, int size)
+{
+  for(int i = 0; i < size; ++i)
+  {
+    if(std::abs(buffer[i]) > MTB::ProcessingChain::SILENCE_THRESHOLD)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+namespace MTB
+{
+ProcessingChain::ProcessingChain()
+  : highPassFilter(createStaticFilter_stage1())
+  , oversamplingFilter(1)
+  , preDistortionToneShapingFilter(createStaticFilter_stage2())
+  , bandPassFilter(createStaticFilter_stage3())
+  , distLevelFilter(createStaticFilter_stage4())
+  , distFilter(createStaticFilter_stage5())
+  , postDistortionToneShapingFilter(createStaticFilter_stage6())
+  , preDistortionToneShapingEcoFilter(createStaticFilter_stage2_eco())
+  , postDistortionToneShapingEcoFilter(createStaticFilter_stage6_eco())
+  , lowpassFilter(1)
+  , decimationFilter(1)
+  , linearPhaseDecimationFilter(1)
+  , toneStackFilter(true)
+{
+  highPassFilter->set_input_port(highPassFilter->find_input_pin("vin"), &inFilter, 0);
+  connect(oversamplingFilter, 0, highPassFilter.get(), highPassFilter->find_dynamic_pin("vout"), Stage::HighPass);
+  connect(*preDistortionToneShapingFilter,
+      preDistortionToneShapingFilter->find_input_pin("vin"),
+      &oversamplingFilter,
+      0,
+      Stage::Oversampling);
+  connect(*bandPassFilter,
+      bandPassFilter->find_input_pin("vin"),
+      preDistortionToneShapingFilter.get(),
+      preDistortionToneShapingFilter->find_dynamic_pin("vout"),
+      Stage::PreDistortionToneShaping);
+  connect(*distLevelFilter,
+      distLevelFilter->find_input_pin("vin"),
+      bandPassFilter.get(),
+      bandPassFilter->find_dynamic_pin("vout"),
+      Stage::BandPass);
+  connect(*distFilter,
+      distFilter->find_input_pin("vin"),
+      distLevelFilter.get(),
+      distLevelFilter->find_dynamic_pin("vout"),
+      Stage::DistLevel);
+  connect(*postDistortionToneShapingFilter,
+      postDistortionToneShapingFilter->find_input_pin("vin"),
+      distFilter.get(),
+      distFilter->find_dynamic_pin("vout"),
+      Stage::Dist);
+  connect(lowpassFilter,
+      0,
+      postDistortionToneShapingFilter.get(),
+      postDistortionToneShapingFilter->find_dynamic_pin("vout"),
+      Stage::PostDistortionToneShaping);
+  decimationFilter.set_input_port(0, &lowpassFilter, 0);
+  connect(toneStackFilter, 0, &decimationFilter, 0, Stage::Decimation);
+  toneStackFilter.set_input_port(1, &midFreqFilter, 0);
+  connect(outFilter, 0, &toneStackFilter, 0, Stage::ToneStack);
+
+  connect(linearPhaseDecimationFilter,
+      0,
+      postDistortionToneShapingFilter.get(),
+      postDistortionToneShapingFilter->find_dynamic_pin("vout"),
+      Stage::PostDistortionToneShaping);
+  connect(*preDistortionToneShapingEcoFilter, 0, &oversamplingFilter, 0, Stage::Oversampling);
+  connect(*postDistortionToneShapingEcoFilter, 0, distFilter.get(), distFilter->find_dynamic_pin("vout"), Stage::Dist);
+
+  lowpassFilter.set_cut_frequency(20000);
+  lowpassFilter.set_order(6);
+  linearPhaseDecimationFilter.set_passband(20000);
+  toneStackFilter.set_dc_cut_frequency(1);
+}
+
+ProcessingChain::~ProcessingChain() = default;
+
+void ProcessingChain::configure(long sampleRate, int maxBlockSize, Resampling resampling, Model model)
+{
+  bool reallocate = maxBlockSize > this->maxBlockSize;
+  if(sampleRate != this->sampleRate)
+  {
+    this->sampleRate = sampleRate;
+    idleHoldSamples = static_cast<int>(sampleRate * IDLE_HOLD);
+    silentSamples = 0;
+    // The linear phase decimation has more taps at higher rates, its delay buffers have to grow here
+    reallocate = true;
+
+    inFilter.set_input_sampling_rate(sampleRate);
+    inFilter.set_output_sampling_rate(sampleRate);
+    highPassFilter->set_input_sampling_rate(sampleRate);
+    highPassFilter->set_output_sampling_rate(sampleRate);
+    oversamplingFilter.set_input_sampling_rate(sampleRate);
+    oversamplingFilter.set_output_sampling_rate(sampleRate * OVERSAMPLING);
+    preDistortionToneShapingFilter->set_input_sampling_rate(sampleRate * OVERSAMPLING);
+    preDistortionToneShapingFilter->set_output_sampling_rate(sampleRate * OVERSAMPLING);
+    bandPassFilter->set_input_sampling_rate(sampleRate * OVERSAMPLING);
+    bandPassFilter->set_output_sampling_rate(sampleRate * OVERSAMPLING);
+    distLevelFilter->set_input_sampling_rate(sampleRate * OVERSAMPLING);
+    distLevelFilter->set_output_sampling_rate(sampleRate * OVERSAMPLING);
+    distFilter->set_input_sampling_rate(sampleRate * OVERSAMPLING);
+    distFilter->set_output_sampling_rate(sampleRate * OVERSAMPLING);
+    postDistortionToneShapingFilter->set_input_sampling_rate(sampleRate * OVERSAMPLING);
+    postDistortionToneShapingFilter->set_output_sampling_rate(sampleRate * OVERSAMPLING);
+    preDistortionToneShapingEcoFilter->set_input_sampling_rate(sampleRate * OVERSAMPLING);
+    preDistortionToneShapingEcoFilter->set_output_sampling_rate(sampleRate * OVERSAMPLING);
+    postDistortionToneShapingEcoFilter->set_input_sampling_rate(sampleRate * OVERSAMPLING);
+    postDistortionToneShapingEcoFilter->set_output_sampling_rate(sampleRate * OVERSAMPLING);
+    lowpassFilter.set_input_sampling_rate(sampleRate * OVERSAMPLING);
+    lowpassFilter.set_output_sampling_rate(sampleRate * OVERSAMPLING);
+    decimationFilter.set_input_sampling_rate(sampleRate * OVERSAMPLING);
+    decimationFilter.set_output_sampling_rate(sampleRate);
+    linearPhaseDecimationFilter.set_input_sampling_rate(sampleRate * OVERSAMPLING);
+    linearPhaseDecimationFilter.set_output_sampling_rate(sampleRate);
+    midFreqFilter.set_input_sampling_rate(sampleRate);
+    midFreqFilter.set_output_sampling_rate(sampleRate);
+    toneStackFilter.set_input_sampling_rate(sampleRate);
+    toneStackFilter.set_output_sampling_rate(sampleRate);
+    outFilter.set_input_sampling_rate(sampleRate);
+    outFilter.set_output_sampling_rate(sampleRate);
+#ifdef CHAIN_PROFILING
+    for(std::size_t i = 0; i < probes.size(); ++i)
+    {
+      const auto stage = static_cast<Stage>(i);
+      const bool oversampled = stage >= Stage::Oversampling && stage <= Stage::PostDistortionToneShaping;
+      probes[i].set_input_sampling_rate(oversampled ? sampleRate * OVERSAMPLING : sampleRate);
+      probes[i].set_output_sampling_rate(oversampled ? sampleRate * OVERSAMPLING : sampleRate);
+    }
+#endif
+
+    toneStackFilter.set_cut_frequency(ToneStackFilter<>::Low, 50);
+    toneStackFilter.set_cut_frequency(ToneStackFilter<>::High, 2500);
+  }
+  if(resampling != this->resampling)
+  {
+    this->resampling = resampling;
+    if(resampling == Resampling::MinimumPhase)
+    {
+      connect(toneStackFilter, 0, &decimationFilter, 0, Stage::Decimation);
+    }
+    else
+    {
+      connect(toneStackFilter, 0, &linearPhaseDecimationFilter, 0, Stage::Decimation);
+    }
+    // The new path has to be allocated as well
+    reallocate = true;
+  }
+  if(model != this->model)
+  {
+    this->model = model;
+    ATK::BaseFilter* preDistortion = preDistortionToneShapingEcoFilter.get();
+    gsl::index preDistortionPort = 0;
+    ATK::BaseFilter* postDistortion = postDistortionToneShapingEcoFilter.get();
+    gsl::index postDistortionPort = 0;
+    if(model == Model::Full)
+    {
+      preDistortion = preDistortionToneShapingFilter.get();
+      preDistortionPort = preDistortionToneShapingFilter->find_dynamic_pin("vout");
+      postDistortion = postDistortionToneShapingFilter.get();
+      postDistortionPort = postDistortionToneShapingFilter->find_dynamic_pin("vout");
+    }
+    connect(*bandPassFilter,
+        bandPassFilter->find_input_pin("vin"),
+        preDistortion,
+        preDistortionPort,
+        Stage::PreDistortionToneShaping);
+    connect(lowpassFilter, 0, postDistortion, postDistortionPort, Stage::PostDistortionToneShaping);
+    connect(linearPhaseDecimationFilter, 0, postDistortion, postDistortionPort, Stage::PostDistortionToneShaping);
+    reallocate = true;
+  }
+  if(reallocate)
+  {
+    this->maxBlockSize = std::max(maxBlockSize, this->maxBlockSize);
+    outFilter.dryrun(this->maxBlockSize);
+  }
+}
+
+long ProcessingChain::getSampleRate() const
+{
+  return sampleRate;
+}
+
+int ProcessingChain::getMaxBlockSize() const
+{
+  return maxBlockSize;
+}
+
+ProcessingChain::Resampling ProcessingChain::getResampling() const
+{
+  return resampling;
+}
+
+ProcessingChain::Model ProcessingChain::getModel() const
+{
+  return model;
+}
+
+double ProcessingChain::computeResamplingLatency(long sampleRate, Resampling resampling)
+{
+  // Long enough for the impulse response of both paths to have died out
+  constexpr int SIZE = 1024;
+
+  std::vector<double> input(SIZE);
+  std::vector<double> output(SIZE);
+  input[0] = 1;
+
+  ATK::InPointerFilter<double> inFilter(input.data(), 1, SIZE, false);
+  ATK::OversamplingFilter<double, ATK::Oversampling6points5order_8<double>> oversamplingFilter(1);
+  ATK::IIRFilter<ATK::ButterworthLowPassCoefficients<double>> lowpassFilter(1);
+  ATK::DecimationFilter<double> decimationFilter(1);
+  LinearPhaseDecimationFilter linearPhaseDecimationFilter(1);
+  ATK::OutPointerFilter<double> outFilter(output.data(), 1, SIZE, false);
+
+  oversamplingFilter.set_input_port(0, &inFilter, 0);
+  lowpassFilter.set_input_port(0, &oversamplingFilter, 0);
+  decimationFilter.set_input_port(0, &lowpassFilter, 0);
+  linearPhaseDecimationFilter.set_input_port(0, &oversamplingFilter, 0);
+  if(resampling == Resampling::MinimumPhase)
+  {
+    outFilter.set_input_port(0, &decimationFilter, 0);
+  }
+  else
+  {
+    outFilter.set_input_port(0, &linearPhaseDecimationFilter, 0);
+  }
+
+  lowpassFilter.set_cut_frequency(20000);
+  lowpassFilter.set_order(6);
+  linearPhaseDecimationFilter.set_passband(20000);
+
+  inFilter.set_input_sampling_rate(sampleRate);
+  inFilter.set_output_sampling_rate(sampleRate);
+  oversamplingFilter.set_input_sampling_rate(sampleRate);
+  oversamplingFilter.set_output_sampling_rate(sampleRate * OVERSAMPLING);
+  lowpassFilter.set_input_sampling_rate(sampleRate * OVERSAMPLING);
+  lowpassFilter.set_output_sampling_rate(sampleRate * OVERSAMPLING);
+  decimationFilter.set_input_sampling_rate(sampleRate * OVERSAMPLING);
+  decimationFilter.set_output_sampling_rate(sampleRate);
+  linearPhaseDecimationFilter.set_input_sampling_rate(sampleRate * OVERSAMPLING);
+  linearPhaseDecimationFilter.set_output_sampling_rate(sampleRate);
+  outFilter.set_input_sampling_rate(sampleRate);
+  outFilter.set_output_sampling_rate(sampleRate);
+
+  outFilter.process(SIZE);
+
+  // Oversampling, filtering and decimating by the same factor is time invariant, the group delay at DC is the
+  // centroid of the impulse response
+  double moment = 0;
+  double gain = 0;
+  for(int i = 0; i < SIZE; ++i)
+  {
+    moment += i * output[i];
+    gain += output[i];
+  }
+  const double delay = moment / gain;
+  assert(delay >= 0 && delay < SIZE / 2);
+  return delay;
+}
+
+void ProcessingChain::setParameters(const Parameters& parameters)
+{
+  if(parameters.distLevel != old_distLevel)
+  {
+    old_distLevel = parameters.distLevel;
+    distLevelFilter->set_parameter(0, old_distLevel * .99 / 100 + .05);
+  }
+  if(parameters.lowLevel != old_lowLevel)
+  {
+    old_lowLevel = parameters.lowLevel;
+    toneStackFilter.set_gain(ToneStackFilter<>::Low, std::pow(10, old_lowLevel / 40));
+  }
+  if(parameters.highLevel != old_highLevel)
+  {
+    old_highLevel = parameters.highLevel;
+    toneStackFilter.set_gain(ToneStackFilter<>::High, std::pow(10, old_highLevel / 40));
+  }
+  if(parameters.midLevel != old_midLevel)
+  {
+    old_midLevel = parameters.midLevel;
+    toneStackFilter.set_gain(ToneStackFilter<>::Mid, std::pow(10, old_midLevel / 40));
+  }
+  if(parameters.midFreq != old_midFreq)
+  {
+    old_midFreq = parameters.midFreq;
+    midFreqFilter.set_target(old_midFreq);
+  }
+  if(parameters.lowQ != old_lowQ)
+  {
+    old_lowQ = parameters.lowQ;
+    toneStackFilter.set_Q(ToneStackFilter<>::Low, old_lowQ);
+  }
+  if(parameters.highQ != old_highQ)
+  {
+    old_highQ = parameters.highQ;
+    toneStackFilter.set_Q(ToneStackFilter<>::High, old_highQ);
+  }
+  if(parameters.midQ != old_midQ)
+  {
+    old_midQ = parameters.midQ;
+    toneStackFilter.set_Q(ToneStackFilter<>::Mid, old_midQ);
+  }
+}
+
+void ProcessingChain::process(const float* input, float* output, int size)
+{
+  assert(size <= maxBlockSize);
+
+  const bool silentInput = isSilent(input, size);
+  idle = silentInput && silentSamples >= idleHoldSamples;
+  if(idle)
+  {
+    std::fill(output, output + size, 0.f);
+#ifdef CHAIN_PROFILING
+    profile = Profile{};
+#endif
+    return;
+  }
+
+  inFilter.set_pointer(input, size);
+  outFilter.set_pointer(output, size);
+
+#ifdef CHAIN_PROFILING
+  auto time = ProfilingFilter::Clock::now();
+#endif
+  outFilter.process(size);
+#ifdef CHAIN_PROFILING
+  // Each probe ran as soon as its stage was done, so consecutive probes bracket a stage
+  for(std::size_t i = 0; i < probes.size(); ++i)
+  {
+    profile.seconds[i] = std::chrono::duration<double>(probes[i].get_time() - time).count();
+    profile.iterations[i] = probes[i].get_iterations();
+    time = probes[i].get_time();
+  }
+#endif
+
+  if(silentInput && isSilent(output, size))
+  {
+    silentSamples = std::min(silentSamples + size, idleHoldSamples);
+  }
+  else
+  {
+    silentSamples = 0;
+  }
+}
+
+bool ProcessingChain::isIdle() const
+{
+  return idle;
+}
+
+#ifdef STAGES_COUNT_ITERATIONS
+std::int64_t ProcessingChain::getNbIterations() const
+{
+  return Stages::get_nb_iterations(*highPassFilter) + Stages::get_nb_iterations(*preDistortionToneShapingFilter)
+       + Stages::get_nb_iterations(*bandPassFilter) + Stages::get_nb_iterations(*distLevelFilter)
+       + Stages::get_nb_iterations(*distFilter) + Stages::get_nb_iterations(*postDistortionToneShapingFilter);
+}
+#endif
+
+#ifdef CHAIN_PROFILING
+const ProcessingChain::Profile& ProcessingChain::getProfile() const
+{
+  return profile;
+}
+
+const char* ProcessingChain::getStageName(Stage stage)
+{
+  switch(stage)
+  {
+  case Stage::HighPass:
+    return "High pass";
+  case Stage::Oversampling:
+    return "Oversampling";
+  case Stage::PreDistortionToneShaping:
+    return "Pre tone shaping";
+  case Stage::BandPass:
+    return "Band pass";
+  case Stage::DistLevel:
+    return "Dist level";
+  case Stage::Dist:
+    return "Dist";
+  case Stage::PostDistortionToneShaping:
+    return "Post tone shaping";
+  case Stage::Decimation:
+    return "Decimation";
+  default:
+    return "Tone stack";
+  }
+}
+#endif
+
+void ProcessingChain::connect(ATK::BaseFilter& filter,
+    gsl::index port,
+    ATK::BaseFilter* input,
+    gsl::index inputPort,
+    [[maybe_unused]] Stage stage)
+{
+#ifdef CHAIN_PROFILING
+  auto& probe = probes[static_cast<std::size_t>(stage)];
+  probe.set_stage(input);
+  probe.set_input_port(0, input, inputPort);
+  filter.set_input_port(port, &probe, 0);
+#else
+  filter.set_input_port(port, input, inputPort);
+#endif
+}
+} // namespace MTB
@@ -0,0 +1,197 @@
+/**
+ * \file ProcessingChain.h
+ */
+
+#ifndef PROCESSING_CHAIN
+#define PROCESSING_CHAIN
+
+#include "Instrumentation.h"
+#include "LinearPhaseDecimationFilter.h"
+#include "PointerFilters.h"
+#ifdef CHAIN_PROFILING
+#  include "ProfilingFilter.h"
+#endif
+#include "RampFilter.h"
+#include "ToneStackFilter.h"
+
+#include <ATK/EQ/ButterworthFilter.h>
+#include <ATK/EQ/IIRFilter.h>
+#include <ATK/Modelling/ModellerFilter.h>
+#include <ATK/Tools/DecimationFilter.h>
+#include <ATK/Tools/OversamplingFilter.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+namespace MTB
+{
+/// The full MTB graph, from the host input buffer to the host output buffer
+/**
+ * The chain doesn't depend on JUCE so that it can be driven by the plugin as well as by headless tools.
+ * All buffers are allocated by configure(), process() never allocates as long as the blocks are not bigger than the
+ * configured maximum block size.
+ * When CHAIN_PROFILING is defined, a probe after each stage times it on every block. The stages then have to be built
+ * with STAGES_COUNT_ITERATIONS as well so that their Newton iterations are counted. Without it, the chain is the same
+ * as without the probes.
+ */
+class ProcessingChain
+{
+public:
+  static constexpr int OVERSAMPLING = 8;
+  /// Level below which the input and the output of the chain are considered silent (-100dB)
+  static constexpr float SILENCE_THRESHOLD = 1e-5f;
+  /// Time the input and output have to stay silent before the chain stops processing, in s
+  static constexpr double IDLE_HOLD = .1;
+
+  /// Filters used to go back to the host sampling rate
+  enum class Resampling
+  {
+    MinimumPhase, ///< IIR lowpass followed by a decimation, low latency
+    LinearPhase ///< FIR linear phase decimation, higher latency
+  };
+
+  /// Models of the tone shaping stages around the distortion
+  enum class Model
+  {
+    Full, ///< Transistor gyrators, solved with Newton iterations
+    Eco ///< Gyrators linearized at their operating point, no iteration
+  };
+
+  /// Stages of the chain, in processing order
+  enum class Stage
+  {
+    HighPass,
+    Oversampling,
+    PreDistortionToneShaping,
+    BandPass,
+    DistLevel,
+    Dist,
+    PostDistortionToneShaping,
+    Decimation, ///< Lowpass and decimation, or linear phase decimation
+    ToneStack, ///< Mid frequency ramp and tone controls
+    Count
+  };
+
+  /// The user parameters of the chain, in the plugin units
+  struct Parameters
+  {
+    float distLevel;
+    float lowLevel;
+    float highLevel;
+    float midLevel;
+    float midFreq;
+    float lowQ;
+    float highQ;
+    float midQ;
+  };
+
+  ProcessingChain();
+  ~ProcessingChain();
+
+  ProcessingChain(const ProcessingChain&) = delete;
+  ProcessingChain& operator=(const ProcessingChain&) = delete;
+
+  /// Sets the host sampling rate and preallocates the buffers of all stages for maxBlockSize samples
+  void configure(long sampleRate, int maxBlockSize, Resampling resampling, Model model);
+  /// Returns the configured host sampling rate, 0 if the chain was never configured
+  long getSampleRate() const;
+  /// Returns the biggest block that can be processed without allocating
+  int getMaxBlockSize() const;
+  /// Returns the configured resampling filters
+  Resampling getResampling() const;
+  /// Returns the configured tone shaping model
+  Model getModel() const;
+
+  /// Measures the delay of the oversampling and decimation stages at low frequencies, in host samples
+  /**
+   * The delay is the group delay at DC of an impulse going through the same resampling filters as the chain, which is
+   * what the host has to compensate to align this chain with other tracks.
+   */
+  static double computeResamplingLatency(long sampleRate, Resampling resampling);
+
+  /// Updates the stages whose parameters changed since the last call
+  /**
+   * The mid frequency is swept sample by sample from its previous value during the next block.
+   * Tone sections at 0 dB are identities and are skipped. They keep their state while they are skipped, and their
+   * contribution to the output is proportional to their gain, so bringing them back is seamless.
+   */
+  void setParameters(const Parameters& parameters);
+
+  /// Processes size samples from input to output, which can be the same buffer
+  /**
+   * When the input and the output stayed silent for IDLE_HOLD, the stages have settled to their DC point and the
+   * chain outputs zeros without running the solvers until the input is above SILENCE_THRESHOLD again. As the stages
+   * stopped on a silent input, they resume from a state consistent with the new input.
+   */
+  void process(const float* input, float* output, int size);
+  /// Returns true if the last block was not processed because the chain is idle
+  bool isIdle() const;
+
+#ifdef STAGES_COUNT_ITERATIONS
+  /// Returns the Newton iterations of the stages of this chain since it was created
+  std::int64_t getNbIterations() const;
+#endif
+
+#ifdef CHAIN_PROFILING
+  static constexpr std::size_t NB_STAGES = static_cast<std::size_t>(Stage::Count);
+
+  /// Cost of each stage during the last processed block, all zeros when the chain was idle
+  struct Profile
+  {
+    std::array<double, NB_STAGES> seconds{};
+    std::array<std::int64_t, NB_STAGES> iterations{};
+  };
+
+  /// Returns the cost of the stages during the last block, only to be called from the thread calling process()
+  const Profile& getProfile() const;
+  static const char* getStageName(Stage stage);
+#endif
+
+private:
+  /// Connects the output of a stage to the port of the next filter, through the probe of the stage when profiling
+  void connect(ATK::BaseFilter& filter, gsl::index port, ATK::BaseFilter* input, gsl::index inputPort, Stage stage);
+
+  FloatInPointerFilter inFilter;
+  std::unique_ptr<ATK::ModellerFilter<double>> highPassFilter;
+  ATK::OversamplingFilter<double, ATK::Oversampling6points5order_8<double>> oversamplingFilter;
+  std::unique_ptr<ATK::ModellerFilter<double>> preDistortionToneShapingFilter;
+  std::unique_ptr<ATK::ModellerFilter<double>> bandPassFilter;
+  std::unique_ptr<ATK::ModellerFilter<double>> distLevelFilter;
+  std::unique_ptr<ATK::ModellerFilter<double>> distFilter;
+  std::unique_ptr<ATK::ModellerFilter<double>> postDistortionToneShapingFilter;
+  std::unique_ptr<ATK::TypedBaseFilter<double>> preDistortionToneShapingEcoFilter;
+  std::unique_ptr<ATK::TypedBaseFilter<double>> postDistortionToneShapingEcoFilter;
+  ATK::IIRFilter<ATK::ButterworthLowPassCoefficients<double>> lowpassFilter;
+  ATK::DecimationFilter<double> decimationFilter;
+  LinearPhaseDecimationFilter linearPhaseDecimationFilter;
+  /// Per sample frequency of the sweepable mid tone control
+  RampFilter midFreqFilter;
+  /// DC filter and the low, high and sweepable mid tone controls
+  ToneStackFilter<> toneStackFilter;
+  FloatOutPointerFilter outFilter;
+#ifdef CHAIN_PROFILING
+  std::array<ProfilingFilter, NB_STAGES> probes;
+  Profile profile;
+#endif
+
+  long sampleRate{0};
+  int maxBlockSize{0};
+  Resampling resampling{Resampling::MinimumPhase};
+  Model model{Model::Full};
+  int idleHoldSamples{0};
+  int silentSamples{0};
+  bool idle{false};
+
+  float old_distLevel{1000};
+  float old_lowLevel{100};
+  float old_highLevel{100};
+  float old_midLevel{100};
+  float old_midFreq{1};
+  float old_lowQ{0};
+  float old_highQ{0};
+  float old_midQ{0};
+};
+} // namespace MTB
+
+#endif
@@ -165,7 +165,7 @@ public:
     // update_steady_state
     c033.update_steady_state(1. / input_sampling_rate, input_state[0], dynamic_state[0]);
 
-    solve<true>();
+    solve<true>(input_state, dynamic_state);
 
     // update_steady_state
     c033.update_steady_state(1. / input_sampling_rate, input_state[0], dynamic_state[0]);
@@ -175,49 +175,52 @@ public:
 
   void process_impl(gsl::index size) const override
   {
+    // The states are kept in locals for the whole block, so that they can stay in registers
+    const DataType* ATK_RESTRICT input0 = converted_inputs[0];
+    DataType* ATK_RESTRICT output0 = outputs[0];
+    Eigen::Matrix<DataType, 1, 1> input = input_state;
+    Eigen::Matrix<DataType, 1, 1> dynamic = dynamic_state;
+
     for(gsl::index i = 0; i < size; ++i)
     {
-      for(gsl::index j = 0; j < nb_input_ports; ++j)
-      {
-        input_state[j] = converted_inputs[j][i];
-      }
+      input[0] = input0[i];
 
-      solve<false>();
+      solve<false>(input, dynamic);
 
       // Update state
-      c033.update_state(input_state[0], dynamic_state[0]);
-      for(gsl::index j = 0; j < nb_output_ports; ++j)
-      {
-        outputs[j][i] = dynamic_state[j];
-      }
+      c033.update_state(input[0], dynamic[0]);
+      output0[i] = dynamic[0];
     }
+
+    input_state = input;
+    dynamic_state = dynamic;
   }
 
   /// Solve for steady state and non steady state the system
   template <bool steady_state>
-  void solve() const
+  void solve(const Eigen::Matrix<DataType, 1, 1>& input, Eigen::Matrix<DataType, 1, 1>& dynamic) const
   {
     gsl::index iteration = 0;
 
     constexpr int current_max_iter = steady_state ? MAX_ITERATION_STEADY_STATE : MAX_ITERATION;
 
-    while(iteration < current_max_iter && !iterate<steady_state>())
+    while(iteration < current_max_iter && !iterate<steady_state>(input, dynamic))
     {
       ++iteration;
     }
   }
 
   template <bool steady_state>
-  bool iterate() const
+  bool iterate(const Eigen::Matrix<DataType, 1, 1>& input, Eigen::Matrix<DataType, 1, 1>& dynamic) const
   {
     // Static states
     auto s0_ = static_state[0];
 
     // Input states
-    auto i0_ = input_state[0];
+    auto i0_ = input[0];
 
     // Dynamic states
-    auto d0_ = dynamic_state[0];
+    auto d0_ = dynamic[0];
 
     // Precomputes
 
@@ -239,7 +242,7 @@ public:
       return true;
     }
 
-    dynamic_state -= delta;
+    dynamic -= delta;
 
     return false;
   }
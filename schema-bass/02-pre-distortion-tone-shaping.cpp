@@ -186,7 +186,7 @@ public:
     c035.update_steady_state(1. / input_sampling_rate, dynamic_state[4], dynamic_state[0]);
     c034.update_steady_state(1. / input_sampling_rate, dynamic_state[2], dynamic_state[4]);
 
-    solve<true>();
+    solve<true>(input_state, dynamic_state);
 
     // update_steady_state
     c032.update_steady_state(1. / input_sampling_rate, dynamic_state[2], dynamic_state[3]);
@@ -198,42 +198,53 @@ public:
 
   void process_impl(gsl::index size) const override
   {
+    // The states are kept in locals for the whole block, so that they can stay in registers
+    const DataType* ATK_RESTRICT input0 = converted_inputs[0];
+    DataType* ATK_RESTRICT output0 = outputs[0];
+    DataType* ATK_RESTRICT output1 = outputs[1];
+    DataType* ATK_RESTRICT output2 = outputs[2];
+    DataType* ATK_RESTRICT output3 = outputs[3];
+    DataType* ATK_RESTRICT output4 = outputs[4];
+    Eigen::Matrix<DataType, 1, 1> input = input_state;
+    Eigen::Matrix<DataType, 5, 1> dynamic = dynamic_state;
+
     for(gsl::index i = 0; i < size; ++i)
     {
-      for(gsl::index j = 0; j < nb_input_ports; ++j)
-      {
-        input_state[j] = converted_inputs[j][i];
-      }
+      input[0] = input0[i];
 
-      solve<false>();
+      solve<false>(input, dynamic);
 
       // Update state
-      c032.update_state(dynamic_state[2], dynamic_state[3]);
-      c035.update_state(dynamic_state[4], dynamic_state[0]);
-      c034.update_state(dynamic_state[2], dynamic_state[4]);
-      for(gsl::index j = 0; j < nb_output_ports; ++j)
-      {
-        outputs[j][i] = dynamic_state[j];
-      }
+      c032.update_state(dynamic[2], dynamic[3]);
+      c035.update_state(dynamic[4], dynamic[0]);
+      c034.update_state(dynamic[2], dynamic[4]);
+      output0[i] = dynamic[0];
+      output1[i] = dynamic[1];
+      output2[i] = dynamic[2];
+      output3[i] = dynamic[3];
+      output4[i] = dynamic[4];
     }
+
+    input_state = input;
+    dynamic_state = dynamic;
   }
 
   /// Solve for steady state and non steady state the system
   template <bool steady_state>
-  void solve() const
+  void solve(const Eigen::Matrix<DataType, 1, 1>& input, Eigen::Matrix<DataType, 5, 1>& dynamic) const
   {
     gsl::index iteration = 0;
 
     constexpr int current_max_iter = steady_state ? MAX_ITERATION_STEADY_STATE : MAX_ITERATION;
 
-    while(iteration < current_max_iter && !iterate<steady_state>())
+    while(iteration < current_max_iter && !iterate<steady_state>(input, dynamic))
     {
       ++iteration;
     }
   }
 
   template <bool steady_state>
-  bool iterate() const
+  bool iterate(const Eigen::Matrix<DataType, 1, 1>& input, Eigen::Matrix<DataType, 5, 1>& dynamic) const
   {
     // Static states
     auto s0_ = static_state[0];
@@ -241,24 +252,24 @@ public:
     auto s2_ = static_state[2];
 
     // Input states
-    auto i0_ = input_state[0];
+    auto i0_ = input[0];
 
     // Dynamic states
-    auto d0_ = dynamic_state[0];
-    auto d1_ = dynamic_state[1];
-    auto d2_ = dynamic_state[2];
-    auto d3_ = dynamic_state[3];
-    auto d4_ = dynamic_state[4];
+    auto d0_ = dynamic[0];
+    auto d1_ = dynamic[1];
+    auto d2_ = dynamic[2];
+    auto d3_ = dynamic[3];
+    auto d4_ = dynamic[4];
 
     // Precomputes
-    q010.precompute(dynamic_state[0], static_state[2], dynamic_state[1]);
+    q010.precompute(dynamic[0], static_state[2], dynamic[1]);
 
     Eigen::Matrix<DataType, 5, 1> eqs(Eigen::Matrix<DataType, 5, 1>::Zero());
     auto eq0 = -q010.ib() - r053.get_current(s0_, d0_) - (steady_state ? 0 : c035.get_current(d4_, d0_));
     auto eq1 = +q010.ib() + q010.ic() - r046.get_current(d4_, d1_) + r054.get_current(d1_, s1_);
     auto eq2 = +(steady_state ? 0 : c032.get_current(d2_, d3_)) + r044.get_current(d2_, d3_)
              + (steady_state ? 0 : c034.get_current(d2_, d4_));
-    auto eq3 = input_state[0] - dynamic_state[2];
+    auto eq3 = input[0] - dynamic[2];
     auto eq4 = +r046.get_current(d4_, d1_) + (steady_state ? 0 : c035.get_current(d4_, d0_))
              - (steady_state ? 0 : c034.get_current(d2_, d4_));
     eqs << eq0, eq1, eq2, eq3, eq4;
@@ -387,7 +398,7 @@ public:
       }
     }
 
-    dynamic_state -= delta;
+    dynamic -= delta;
 
     return false;
   }
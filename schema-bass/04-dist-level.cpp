@@ -178,7 +178,7 @@ public:
     c028.update_steady_state(1. / input_sampling_rate, dynamic_state[1], dynamic_state[0]);
     r041c030.update_steady_state(1. / input_sampling_rate, static_state[0], dynamic_state[0]);
 
-    solve<true>();
+    solve<true>(input_state, dynamic_state);
 
     // update_steady_state
     c028.update_steady_state(1. / input_sampling_rate, dynamic_state[1], dynamic_state[0]);
@@ -189,58 +189,63 @@ public:
 
   void process_impl(gsl::index size) const override
   {
+    // The states are kept in locals for the whole block, so that they can stay in registers
+    const DataType* ATK_RESTRICT input0 = converted_inputs[0];
+    DataType* ATK_RESTRICT output0 = outputs[0];
+    DataType* ATK_RESTRICT output1 = outputs[1];
+    Eigen::Matrix<DataType, 1, 1> input = input_state;
+    Eigen::Matrix<DataType, 2, 1> dynamic = dynamic_state;
+
     for(gsl::index i = 0; i < size; ++i)
     {
-      for(gsl::index j = 0; j < nb_input_ports; ++j)
-      {
-        input_state[j] = converted_inputs[j][i];
-      }
+      input[0] = input0[i];
 
-      solve<false>();
+      solve<false>(input, dynamic);
 
       // Update state
-      c028.update_state(dynamic_state[1], dynamic_state[0]);
-      r041c030.update_state(static_state[0], dynamic_state[0]);
-      for(gsl::index j = 0; j < nb_output_ports; ++j)
-      {
-        outputs[j][i] = dynamic_state[j];
-      }
+      c028.update_state(dynamic[1], dynamic[0]);
+      r041c030.update_state(static_state[0], dynamic[0]);
+      output0[i] = dynamic[0];
+      output1[i] = dynamic[1];
     }
+
+    input_state = input;
+    dynamic_state = dynamic;
   }
 
   /// Solve for steady state and non steady state the system
   template <bool steady_state>
-  void solve() const
+  void solve(const Eigen::Matrix<DataType, 1, 1>& input, Eigen::Matrix<DataType, 2, 1>& dynamic) const
   {
     gsl::index iteration = 0;
 
     constexpr int current_max_iter = steady_state ? MAX_ITERATION_STEADY_STATE : MAX_ITERATION;
 
-    while(iteration < current_max_iter && !iterate<steady_state>())
+    while(iteration < current_max_iter && !iterate<steady_state>(input, dynamic))
     {
       ++iteration;
     }
   }
 
   template <bool steady_state>
-  bool iterate() const
+  bool iterate(const Eigen::Matrix<DataType, 1, 1>& input, Eigen::Matrix<DataType, 2, 1>& dynamic) const
   {
     // Static states
     auto s0_ = static_state[0];
 
     // Input states
-    auto i0_ = input_state[0];
+    auto i0_ = input[0];
 
     // Dynamic states
-    auto d0_ = dynamic_state[0];
-    auto d1_ = dynamic_state[1];
+    auto d0_ = dynamic[0];
+    auto d1_ = dynamic[1];
 
     // Precomputes
 
     Eigen::Matrix<DataType, 2, 1> eqs(Eigen::Matrix<DataType, 2, 1>::Zero());
     auto eq0 = +(pr01_trimmer != 0 ? (d1_ - d0_) / (pr01_trimmer * pr01) : 0)
              - (steady_state ? 0 : c028.get_current(d1_, d0_)) - (steady_state ? 0 : r041c030.get_current(s0_, d0_));
-    auto eq1 = input_state[0] - dynamic_state[0];
+    auto eq1 = input[0] - dynamic[0];
     eqs << eq0, eq1;
 
     // Check if the equations have converged
@@ -271,7 +276,7 @@ public:
       return true;
     }
 
-    dynamic_state -= delta;
+    dynamic -= delta;
 
     return false;
   }
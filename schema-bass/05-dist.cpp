@@ -165,7 +165,7 @@ public:
     r033c027.update_steady_state(1. / input_sampling_rate, input_state[0], dynamic_state[0]);
     r031c023.update_steady_state(1. / input_sampling_rate, dynamic_state[1], static_state[0]);
 
-    solve<true>();
+    solve<true>(input_state, dynamic_state);
 
     // update_steady_state
     r033c027.update_steady_state(1. / input_sampling_rate, input_state[0], dynamic_state[0]);
@@ -176,54 +176,59 @@ public:
 
   void process_impl(gsl::index size) const override
   {
+    // The states are kept in locals for the whole block, so that they can stay in registers
+    const DataType* ATK_RESTRICT input0 = converted_inputs[0];
+    DataType* ATK_RESTRICT output0 = outputs[0];
+    DataType* ATK_RESTRICT output1 = outputs[1];
+    Eigen::Matrix<DataType, 1, 1> input = input_state;
+    Eigen::Matrix<DataType, 2, 1> dynamic = dynamic_state;
+
     for(gsl::index i = 0; i < size; ++i)
     {
-      for(gsl::index j = 0; j < nb_input_ports; ++j)
-      {
-        input_state[j] = converted_inputs[j][i];
-      }
+      input[0] = input0[i];
 
-      solve<false>();
+      solve<false>(input, dynamic);
 
       // Update state
-      r033c027.update_state(input_state[0], dynamic_state[0]);
-      r031c023.update_state(dynamic_state[1], static_state[0]);
-      for(gsl::index j = 0; j < nb_output_ports; ++j)
-      {
-        outputs[j][i] = dynamic_state[j];
-      }
+      r033c027.update_state(input[0], dynamic[0]);
+      r031c023.update_state(dynamic[1], static_state[0]);
+      output0[i] = dynamic[0];
+      output1[i] = dynamic[1];
     }
+
+    input_state = input;
+    dynamic_state = dynamic;
   }
 
   /// Solve for steady state and non steady state the system
   template <bool steady_state>
-  void solve() const
+  void solve(const Eigen::Matrix<DataType, 1, 1>& input, Eigen::Matrix<DataType, 2, 1>& dynamic) const
   {
     gsl::index iteration = 0;
 
     constexpr int current_max_iter = steady_state ? MAX_ITERATION_STEADY_STATE : MAX_ITERATION;
 
-    while(iteration < current_max_iter && !iterate<steady_state>())
+    while(iteration < current_max_iter && !iterate<steady_state>(input, dynamic))
     {
       ++iteration;
     }
   }
 
   template <bool steady_state>
-  bool iterate() const
+  bool iterate(const Eigen::Matrix<DataType, 1, 1>& input, Eigen::Matrix<DataType, 2, 1>& dynamic) const
   {
     // Static states
     auto s0_ = static_state[0];
 
     // Input states
-    auto i0_ = input_state[0];
+    auto i0_ = input[0];
 
     // Dynamic states
-    auto d0_ = dynamic_state[0];
-    auto d1_ = dynamic_state[1];
+    auto d0_ = dynamic[0];
+    auto d1_ = dynamic[1];
 
     // Precomputes
-    d004d003.precompute(dynamic_state[0], static_state[0]);
+    d004d003.precompute(dynamic[0], static_state[0]);
 
     Eigen::Matrix<DataType, 2, 1> eqs(Eigen::Matrix<DataType, 2, 1>::Zero());
     auto eq0
@@ -268,7 +273,7 @@ public:
       }
     }
 
-    dynamic_state -= delta;
+    dynamic -= delta;
 
     return false;
   }
@@ -1,4 +1,5 @@
 #include "../MTB/Source/static_elements.h"
+#include "../schema/CharacterizationFile.h"
 
 #include <ATK/Core/InPointerFilter.h>
 #include <ATK/Core/OutPointerFilter.h>
@@ -10,7 +11,6 @@
 
 #include <boost/math/constants/constants.hpp>
 
-#include <fstream>
 #include <memory>
 #include <vector>
 
@@ -91,9 +91,5 @@ int main(int argc, const char** argv)
     outFilter.process(1024);
   }
 
-  std::ofstream out(argv[1]);
-  for(size_t i = 0; i < PROCESSSIZE; ++i)
-  {
-    out << input[i] << "\t" << output[i] << std::endl;
-  }
+  write_characterization(argv[1], SAMPLING_RATE, input, output);
 }
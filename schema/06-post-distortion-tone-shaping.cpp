@@ -208,7 +208,7 @@ public:
     c020.update_steady_state(1. / input_sampling_rate, dynamic_state[2], dynamic_state[5]);
     c022.update_steady_state(1. / input_sampling_rate, dynamic_state[2], dynamic_state[7]);
 
-    solve<true>();
+    solve<true>(input_state, dynamic_state);
 
     // update_steady_state
     c024.update_steady_state(1. / input_sampling_rate, dynamic_state[2], dynamic_state[3]);
@@ -222,44 +222,61 @@ public:
 
   void process_impl(gsl::index size) const override
   {
+    // The states are kept in locals for the whole block, so that they can stay in registers
+    const DataType* ATK_RESTRICT input0 = converted_inputs[0];
+    DataType* ATK_RESTRICT output0 = outputs[0];
+    DataType* ATK_RESTRICT output1 = outputs[1];
+    DataType* ATK_RESTRICT output2 = outputs[2];
+    DataType* ATK_RESTRICT output3 = outputs[3];
+    DataType* ATK_RESTRICT output4 = outputs[4];
+    DataType* ATK_RESTRICT output5 = outputs[5];
+    DataType* ATK_RESTRICT output6 = outputs[6];
+    DataType* ATK_RESTRICT output7 = outputs[7];
+    Eigen::Matrix<DataType, 1, 1> input = input_state;
+    Eigen::Matrix<DataType, 8, 1> dynamic = dynamic_state;
+
     for(gsl::index i = 0; i < size; ++i)
     {
-      for(gsl::index j = 0; j < nb_input_ports; ++j)
-      {
-        input_state[j] = converted_inputs[j][i];
-      }
+      input[0] = input0[i];
 
-      solve<false>();
+      solve<false>(input, dynamic);
 
       // Update state
-      c024.update_state(dynamic_state[2], dynamic_state[3]);
-      c017.update_state(dynamic_state[5], dynamic_state[4]);
-      c025.update_state(dynamic_state[3], dynamic_state[0]);
-      c020.update_state(dynamic_state[2], dynamic_state[5]);
-      c022.update_state(dynamic_state[2], dynamic_state[7]);
-      for(gsl::index j = 0; j < nb_output_ports; ++j)
-      {
-        outputs[j][i] = dynamic_state[j];
-      }
+      c024.update_state(dynamic[2], dynamic[3]);
+      c017.update_state(dynamic[5], dynamic[4]);
+      c025.update_state(dynamic[3], dynamic[0]);
+      c020.update_state(dynamic[2], dynamic[5]);
+      c022.update_state(dynamic[2], dynamic[7]);
+      output0[i] = dynamic[0];
+      output1[i] = dynamic[1];
+      output2[i] = dynamic[2];
+      output3[i] = dynamic[3];
+      output4[i] = dynamic[4];
+      output5[i] = dynamic[5];
+      output6[i] = dynamic[6];
+      output7[i] = dynamic[7];
     }
+
+    input_state = input;
+    dynamic_state = dynamic;
   }
 
   /// Solve for steady state and non steady state the system
   template <bool steady_state>
-  void solve() const
+  void solve(const Eigen::Matrix<DataType, 1, 1>& input, Eigen::Matrix<DataType, 8, 1>& dynamic) const
   {
     gsl::index iteration = 0;
 
     constexpr int current_max_iter = steady_state ? MAX_ITERATION_STEADY_STATE : MAX_ITERATION;
 
-    while(iteration < current_max_iter && !iterate<steady_state>())
+    while(iteration < current_max_iter && !iterate<steady_state>(input, dynamic))
     {
       ++iteration;
     }
   }
 
   template <bool steady_state>
-  bool iterate() const
+  bool iterate(const Eigen::Matrix<DataType, 1, 1>& input, Eigen::Matrix<DataType, 8, 1>& dynamic) const
   {
     // Static states
     auto s0_ = static_state[0];
@@ -267,21 +284,21 @@ public:
     auto s2_ = static_state[2];
 
     // Input states
-    auto i0_ = input_state[0];
+    auto i0_ = input[0];
 
     // Dynamic states
-    auto d0_ = dynamic_state[0];
-    auto d1_ = dynamic_state[1];
-    auto d2_ = dynamic_state[2];
-    auto d3_ = dynamic_state[3];
-    auto d4_ = dynamic_state[4];
-    auto d5_ = dynamic_state[5];
-    auto d6_ = dynamic_state[6];
-    auto d7_ = dynamic_state[7];
+    auto d0_ = dynamic[0];
+    auto d1_ = dynamic[1];
+    auto d2_ = dynamic[2];
+    auto d3_ = dynamic[3];
+    auto d4_ = dynamic[4];
+    auto d5_ = dynamic[5];
+    auto d6_ = dynamic[6];
+    auto d7_ = dynamic[7];
 
     // Precomputes
-    q008.precompute(dynamic_state[0], static_state[1], dynamic_state[1]);
-    q007.precompute(dynamic_state[4], static_state[1], dynamic_state[6]);
+    q008.precompute(dynamic[0], static_state[1], dynamic[1]);
+    q007.precompute(dynamic[4], static_state[1], dynamic[6]);
 
     Eigen::Matrix<DataType, 8, 1> eqs(Eigen::Matrix<DataType, 8, 1>::Zero());
     auto eq0 = -q008.ib() - r036.get_current(s0_, d0_) - (steady_state ? 0 : c025.get_current(d3_, d0_));
@@ -294,7 +311,7 @@ public:
     auto eq5 = +(steady_state ? 0 : c017.get_current(d5_, d4_)) + r027.get_current(d5_, d6_)
              - (steady_state ? 0 : c020.get_current(d2_, d5_));
     auto eq6 = +r024.get_current(d6_, s2_) + q007.ib() + q007.ic() - r027.get_current(d5_, d6_);
-    auto eq7 = input_state[0] - dynamic_state[2];
+    auto eq7 = input[0] - dynamic[2];
     eqs << eq0, eq1, eq2, eq3, eq4, eq5, eq6, eq7;
 
     // Check if the equations have converged
@@ -1332,7 +1349,7 @@ public:
       }
     }
 
-    dynamic_state -= delta;
+    dynamic -= delta;
 
     return false;
   }
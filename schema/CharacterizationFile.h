@@ -0,0 +1,122 @@
+/**
+ * \file CharacterizationFile.h
+ * Output of the characterization programs, read back by display.py and the regression tests
+ */
+
+#ifndef CHARACTERIZATION_FILE
+#define CHARACTERIZATION_FILE
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/// Writes the input and the output of a characterization as interleaved float64 samples
+/**
+ * A filename ending with .wav gets a stereo WAV header in IEEE float format, any other file is raw, so that
+ * display.py maps it with np.memmap. The samples are written in the byte order of the machine, little endian on the
+ * platforms the plugins are built for, which is also the byte order of WAV files.
+ */
+inline void write_characterization(const std::string& filename,
+    std::uint32_t sampling_rate,
+    const std::vector<double>& input,
+    const std::vector<double>& output)
+{
+  std::ofstream out(filename, std::ios::binary);
+  if(!out)
+  {
+    throw std::runtime_error("Can't open " + filename);
+  }
+
+  constexpr std::uint16_t channels = 2;
+  const auto data_size = static_cast<std::uint32_t>(input.size() * channels * sizeof(double));
+  auto write = [&out](auto value) { out.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+
+  if(filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".wav") == 0)
+  {
+    // RIFF header, fmt chunk with WAVE_FORMAT_IEEE_FLOAT, fact chunk required for non PCM formats, then data
+    out.write("RIFF", 4);
+    write(static_cast<std::uint32_t>(4 + (8 + 18) + (8 + 4) + 8 + data_size));
+    out.write("WAVEfmt ", 8);
+    write(std::uint32_t{18});
+    write(std::uint16_t{3});
+    write(channels);
+    write(sampling_rate);
+    write(static_cast<std::uint32_t>(sampling_rate * channels * sizeof(double)));
+    write(static_cast<std::uint16_t>(channels * sizeof(double)));
+    write(static_cast<std::uint16_t>(8 * sizeof(double)));
+    write(std::uint16_t{0});
+    out.write("fact", 4);
+    write(std::uint32_t{4});
+    write(static_cast<std::uint32_t>(input.size()));
+    out.write("data", 4);
+    write(data_size);
+  }
+
+  // Interleaved by chunks, the file is written with a few large writes instead of one per sample
+  constexpr size_t CHUNK = 64 * 1024;
+  std::vector<double> buffer(2 * CHUNK);
+  for(size_t i = 0; i < input.size(); i += CHUNK)
+  {
+    const size_t size = std::min(CHUNK, input.size() - i);
+    for(size_t j = 0; j < size; ++j)
+    {
+      buffer[2 * j] = input[i + j];
+      buffer[2 * j + 1] = output[i + j];
+    }
+    out.write(reinterpret_cast<const char*>(buffer.data()), 2 * size * sizeof(double));
+  }
+  if(!out)
+  {
+    throw std::runtime_error("Can't write " + filename);
+  }
+}
+
+/// Reads a file written by write_characterization(), raw or WAV
+inline void read_characterization(const std::string& filename, std::vector<double>& input, std::vector<double>& output)
+{
+  std::ifstream in(filename, std::ios::binary);
+  if(!in)
+  {
+    throw std::runtime_error("Can't open " + filename);
+  }
+  in.seekg(0, std::ios::end);
+  auto size = static_cast<std::uint64_t>(in.tellg());
+  in.seekg(0);
+
+  if(filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".wav") == 0)
+  {
+    // Skips the chunks up to the data one
+    char id[4];
+    std::uint32_t chunk_size;
+    in.seekg(12);
+    while(in.read(id, 4) && in.read(reinterpret_cast<char*>(&chunk_size), sizeof(chunk_size))
+          && std::string(id, 4) != "data")
+    {
+      in.seekg(chunk_size + chunk_size % 2, std::ios::cur);
+    }
+    if(!in)
+    {
+      throw std::runtime_error(filename + " has no data chunk");
+    }
+    size = chunk_size;
+  }
+
+  std::vector<double> buffer(size / sizeof(double));
+  in.read(reinterpret_cast<char*>(buffer.data()), buffer.size() * sizeof(double));
+  if(!in)
+  {
+    throw std::runtime_error("Can't read " + filename);
+  }
+  input.resize(buffer.size() / 2);
+  output.resize(buffer.size() / 2);
+  for(size_t i = 0; i < input.size(); ++i)
+  {
+    input[i] = buffer[2 * i];
+    output[i] = buffer[2 * i + 1];
+  }
+}
+
+#endif
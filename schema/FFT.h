@@ -0,0 +1,71 @@
+/**
+ * \file FFT.h
+ * Radix 2 FFT of the analysis tools
+ */
+
+#ifndef SCHEMA_FFT
+#define SCHEMA_FFT
+
+#include <boost/math/constants/constants.hpp>
+
+#include <complex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/// In place FFT of data, whose size is a power of 2, the inverse transform is scaled by 1 / size
+inline void fft(std::vector<std::complex<double>>& data, bool inverse = false)
+{
+  const size_t size = data.size();
+  if(size == 0 || (size & (size - 1)) != 0)
+  {
+    throw std::invalid_argument("The FFT size must be a power of 2");
+  }
+
+  for(size_t i = 1, j = 0; i < size; ++i)
+  {
+    size_t bit = size >> 1;
+    for(; j & bit; bit >>= 1)
+    {
+      j ^= bit;
+    }
+    j ^= bit;
+    if(i < j)
+    {
+      std::swap(data[i], data[j]);
+    }
+  }
+
+  // The twiddles of the last pass, the previous passes use every other one of them
+  const double pi = boost::math::constants::pi<double>();
+  std::vector<std::complex<double>> twiddles(size / 2);
+  for(size_t i = 0; i < twiddles.size(); ++i)
+  {
+    twiddles[i] = std::polar(1., (inverse ? 2 : -2) * pi * i / size);
+  }
+
+  for(size_t length = 2; length <= size; length <<= 1)
+  {
+    const size_t stride = size / length;
+    for(size_t i = 0; i < size; i += length)
+    {
+      for(size_t j = 0; j < length / 2; ++j)
+      {
+        const auto u = data[i + j];
+        const auto v = data[i + j + length / 2] * twiddles[j * stride];
+        data[i + j] = u + v;
+        data[i + j + length / 2] = u - v;
+      }
+    }
+  }
+
+  if(inverse)
+  {
+    for(auto& value : data)
+    {
+      value /= static_cast<double>(size);
+    }
+  }
+}
+
+#endif
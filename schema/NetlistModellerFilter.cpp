@@ -0,0 +1,808 @@
+/**
+ * \file NetlistModellerFilter.cpp
+ */
+
+#include "NetlistModellerFilter.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+namespace
+{
+constexpr gsl::index MAX_ITERATION{10};
+constexpr gsl::index MAX_ITERATION_STEADY_STATE{200};
+
+constexpr gsl::index INIT_WARMUP{10};
+constexpr double EPS{1e-8};
+constexpr double MAX_DELTA{1e-1};
+/// Conductance of a coil in steady state, where it is a short circuit
+constexpr double COIL_STEADY_STATE_CONDUCTANCE{1e3};
+
+std::string lower(std::string text)
+{
+  std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return std::tolower(c); });
+  return text;
+}
+
+/// Parses a SPICE value, with its optional multiplier and unit (10uF, 2.2k, 1meg...)
+double parse_value(const std::string& text)
+{
+  std::size_t end = 0;
+  double value = 0;
+  try
+  {
+    value = std::stod(text, &end);
+  }
+  catch(const std::exception&)
+  {
+    throw ATK::RuntimeError("Can't parse value " + text);
+  }
+  const auto suffix = lower(text.substr(end));
+  if(suffix.compare(0, 3, "meg") == 0)
+  {
+    return value * 1e6;
+  }
+  static const std::map<char, double> multipliers{
+      {'t', 1e12}, {'g', 1e9}, {'k', 1e3}, {'m', 1e-3}, {'u', 1e-6}, {'n', 1e-9}, {'p', 1e-12}, {'f', 1e-15}};
+  if(!suffix.empty())
+  {
+    auto multiplier = multipliers.find(suffix[0]);
+    if(multiplier != multipliers.end())
+    {
+      return value * multiplier->second;
+    }
+  }
+  return value;
+}
+
+/// Parameters of a .model line, in lower case
+std::map<std::string, double> parse_model(const std::string& line)
+{
+  auto begin = line.find('(');
+  auto end = line.rfind(')');
+  if(begin == std::string::npos || end == std::string::npos)
+  {
+    throw ATK::RuntimeError("Can't parse model " + line);
+  }
+  std::map<std::string, double> parameters;
+  std::istringstream stream(line.substr(begin + 1, end - begin - 1));
+  std::string parameter;
+  while(stream >> parameter)
+  {
+    auto equal = parameter.find('=');
+    if(equal == std::string::npos)
+    {
+      throw ATK::RuntimeError("Can't parse model parameter " + parameter);
+    }
+    parameters[lower(parameter.substr(0, equal))] = parse_value(parameter.substr(equal + 1));
+  }
+  return parameters;
+}
+
+double get_model_parameter(const std::map<std::string, double>& model, const std::string& name, double value)
+{
+  auto parameter = model.find(name);
+  return parameter == model.end() ? value : parameter->second;
+}
+} // namespace
+
+NetlistModellerFilter::NetlistModellerFilter(std::istream& netlist)
+  : Parent(0, 0)
+{
+  parse(netlist);
+  set_nb_input_ports(input_names.size());
+  set_nb_output_ports(dynamic_names.size());
+
+  static_state = Eigen::Map<Eigen::Matrix<DataType, Eigen::Dynamic, 1>>(static_values.data(), static_values.size());
+  input_state = Eigen::Matrix<DataType, Eigen::Dynamic, 1>::Zero(input_names.size());
+  dynamic_state = Eigen::Matrix<DataType, Eigen::Dynamic, 1>::Zero(dynamic_names.size());
+  eqs = Eigen::Matrix<DataType, Eigen::Dynamic, 1>::Zero(dynamic_names.size());
+  delta = Eigen::Matrix<DataType, Eigen::Dynamic, 1>::Zero(dynamic_names.size());
+  build_pattern();
+}
+
+NetlistModellerFilter::~NetlistModellerFilter() = default;
+
+std::unique_ptr<NetlistModellerFilter> NetlistModellerFilter::load(const std::string& filename)
+{
+  std::ifstream netlist(filename);
+  if(!netlist)
+  {
+    throw ATK::RuntimeError("Can't open " + filename);
+  }
+  return std::make_unique<NetlistModellerFilter>(netlist);
+}
+
+void NetlistModellerFilter::parse(std::istream& netlist)
+{
+  std::vector<std::vector<std::string>> elements;
+  std::map<std::string, std::map<std::string, double>> models;
+  std::string line;
+  while(std::getline(netlist, line))
+  {
+    std::istringstream stream(line);
+    std::vector<std::string> tokens;
+    std::string token;
+    while(stream >> token)
+    {
+      tokens.push_back(token);
+    }
+    if(tokens.empty() || tokens[0][0] == '*')
+    {
+      continue;
+    }
+    if(lower(tokens[0]) == ".model")
+    {
+      if(tokens.size() < 3)
+      {
+        throw ATK::RuntimeError("Can't parse model " + line);
+      }
+      models[tokens[1]] = parse_model(line);
+      continue;
+    }
+    elements.push_back(tokens);
+  }
+
+  // The sources define the static and input pins, they have to be known before the other pins
+  for(const auto& element: elements)
+  {
+    if(std::toupper(element[0][0]) != 'V')
+    {
+      continue;
+    }
+    if(element.size() < 5 || element[2] != "0")
+    {
+      throw ATK::RuntimeError("Voltage sources have to be referenced to the ground: " + element[0]);
+    }
+    if(lower(element[3]) == "dc")
+    {
+      static_names.push_back(lower(element[1]));
+      static_values.push_back(parse_value(element[4]));
+    }
+    else
+    {
+      input_names.push_back(lower(element[1]));
+    }
+  }
+
+  const auto check = [](const std::vector<std::string>& element, std::size_t size) {
+    if(element.size() < size)
+    {
+      throw ATK::RuntimeError("Not enough fields for " + element[0]);
+    }
+  };
+  const auto get_model = [&models](const std::string& name) -> const std::map<std::string, double>& {
+    auto model = models.find(name);
+    if(model == models.end())
+    {
+      throw ATK::RuntimeError("Unknown model " + name);
+    }
+    return model->second;
+  };
+
+  for(const auto& element: elements)
+  {
+    switch(std::toupper(element[0][0]))
+    {
+    case 'V':
+      break;
+    case 'R':
+      check(element, 4);
+      resistors.push_back({{get_pin(element[1]), get_pin(element[2]), {}}, 1 / parse_value(element[3])});
+      break;
+    case 'C':
+      check(element, 4);
+      capacitors.push_back({{get_pin(element[1]), get_pin(element[2]), {}}, parse_value(element[3])});
+      break;
+    case 'L':
+      check(element, 4);
+      coils.push_back({{get_pin(element[1]), get_pin(element[2]), {}}, parse_value(element[3])});
+      break;
+    case 'P':
+    {
+      check(element, 5);
+      const auto wiper = get_pin(element[3]);
+      potentiometers.push_back({{get_pin(element[1]), wiper, {}},
+          {wiper, get_pin(element[2]), {}},
+          parse_value(element[4]),
+          lower(element[0])});
+      break;
+    }
+    case 'D':
+    {
+      check(element, 4);
+      const auto& model = get_model(element[3]);
+      diodes.push_back({{get_pin(element[1]), get_pin(element[2]), {}},
+          get_model_parameter(model, "is", 1e-14),
+          get_model_parameter(model, "n", 1) * get_model_parameter(model, "vt", 26e-3)});
+      break;
+    }
+    case 'Q':
+    {
+      check(element, 5);
+      const auto& model = get_model(element[4]);
+      transistors.push_back({{{get_pin(element[1]), get_pin(element[2]), get_pin(element[3])}},
+          {},
+          get_model_parameter(model, "is", 1e-12),
+          get_model_parameter(model, "ne", 1) * get_model_parameter(model, "vt", 26e-3),
+          get_model_parameter(model, "bf", 100),
+          get_model_parameter(model, "br", 1)});
+      break;
+    }
+    case 'Z':
+      check(element, 4);
+      opamps.push_back({get_pin(element[1]), get_pin(element[2]), get_pin(element[3])});
+      break;
+    default:
+      throw ATK::RuntimeError("Unsupported element " + element[0]);
+    }
+  }
+
+  linear = diodes.empty() && transistors.empty();
+  kirchhoff.assign(dynamic_names.size(), true);
+  for(const auto& opamp: opamps)
+  {
+    if(opamp.output.type != PinType::Dynamic || !kirchhoff[opamp.output.index])
+    {
+      throw ATK::RuntimeError("Opamp outputs have to be distinct dynamic pins");
+    }
+    kirchhoff[opamp.output.index] = false;
+  }
+  if(dynamic_names.empty())
+  {
+    throw ATK::RuntimeError("The netlist has no dynamic pin");
+  }
+}
+
+NetlistModellerFilter::Pin NetlistModellerFilter::get_pin(const std::string& name)
+{
+  const auto pin = lower(name);
+  for(const auto& [names, type]: {std::make_pair(&static_names, PinType::Static),
+          std::make_pair(&input_names, PinType::Input),
+          std::make_pair(&dynamic_names, PinType::Dynamic)})
+  {
+    auto position = std::find(names->begin(), names->end(), pin);
+    if(position != names->end())
+    {
+      return {type, position - names->begin()};
+    }
+  }
+  dynamic_names.push_back(pin);
+  return {PinType::Dynamic, static_cast<gsl::index>(dynamic_names.size() - 1)};
+}
+
+void NetlistModellerFilter::build_pattern()
+{
+  // Every entry that a component can write, the other ones are structural zeros
+  std::vector<Eigen::Triplet<DataType>> entries;
+  const auto add = [this, &entries](const Pin& row, const Pin& column) {
+    if(row.type == PinType::Dynamic && kirchhoff[row.index] && column.type == PinType::Dynamic)
+    {
+      entries.emplace_back(row.index, column.index, 0);
+    }
+  };
+  const auto add_two_pins = [&add](const TwoPins& component) {
+    add(component.a, component.a);
+    add(component.a, component.b);
+    add(component.b, component.a);
+    add(component.b, component.b);
+  };
+  for(const auto& component: resistors)
+  {
+    add_two_pins(component);
+  }
+  for(const auto& component: capacitors)
+  {
+    add_two_pins(component);
+  }
+  for(const auto& component: coils)
+  {
+    add_two_pins(component);
+  }
+  for(const auto& component: potentiometers)
+  {
+    add_two_pins(component.first);
+    add_two_pins(component.second);
+  }
+  for(const auto& component: diodes)
+  {
+    add_two_pins(component);
+  }
+  for(const auto& component: transistors)
+  {
+    for(const auto& row: component.pins)
+    {
+      for(const auto& column: component.pins)
+      {
+        add(row, column);
+      }
+    }
+  }
+  for(const auto& opamp: opamps)
+  {
+    for(const auto& input: {opamp.plus, opamp.minus})
+    {
+      if(input.type == PinType::Dynamic)
+      {
+        entries.emplace_back(opamp.output.index, input.index, 0);
+      }
+    }
+  }
+
+  const auto size = static_cast<Eigen::Index>(dynamic_names.size());
+  jacobian.resize(size, size);
+  jacobian.setFromTriplets(entries.begin(), entries.end());
+  jacobian.makeCompressed();
+
+  const auto position = [this](const Pin& row, const Pin& column) -> gsl::index {
+    if(row.type != PinType::Dynamic || !kirchhoff[row.index] || column.type != PinType::Dynamic)
+    {
+      return -1;
+    }
+    return &jacobian.coeffRef(row.index, column.index) - jacobian.valuePtr();
+  };
+  const auto stamp = [&position](TwoPins& component) {
+    component.stamp = {
+        {position(component.a, component.a), position(component.a, component.b), position(component.b, component.a),
+            position(component.b, component.b)}};
+  };
+  for(auto& component: resistors)
+  {
+    stamp(component);
+  }
+  for(auto& component: capacitors)
+  {
+    stamp(component);
+  }
+  for(auto& component: coils)
+  {
+    stamp(component);
+  }
+  for(auto& component: potentiometers)
+  {
+    stamp(component.first);
+    stamp(component.second);
+  }
+  for(auto& component: diodes)
+  {
+    stamp(component);
+  }
+  for(auto& component: transistors)
+  {
+    for(std::size_t row = 0; row < 3; ++row)
+    {
+      for(std::size_t column = 0; column < 3; ++column)
+      {
+        component.stamp[3 * row + column] = position(component.pins[row], component.pins[column]);
+      }
+    }
+  }
+
+  for(auto& solver: solvers)
+  {
+    solver.analyzePattern(jacobian);
+  }
+}
+
+void NetlistModellerFilter::stamp_linear()
+{
+  DataType* values = jacobian.valuePtr();
+  const auto stamp = [values](const Stamp& stamp, DataType conductance) {
+    for(std::size_t i = 0; i < stamp.size(); ++i)
+    {
+      if(stamp[i] >= 0)
+      {
+        values[stamp[i]] += (i == 0 || i == 3) ? conductance : -conductance;
+      }
+    }
+  };
+
+  for(int steady_state = 0; steady_state < 2; ++steady_state)
+  {
+    std::fill(values, values + jacobian.nonZeros(), 0);
+    for(const auto& component: resistors)
+    {
+      stamp(component.stamp, component.conductance);
+    }
+    for(const auto& component: potentiometers)
+    {
+      if(component.trimmer != 0)
+      {
+        stamp(component.first.stamp, 1 / (component.trimmer * component.resistance));
+      }
+      if(component.trimmer != 1)
+      {
+        stamp(component.second.stamp, 1 / ((1 - component.trimmer) * component.resistance));
+      }
+    }
+    if(!steady_state)
+    {
+      for(const auto& component: capacitors)
+      {
+        stamp(component.stamp, component.conductance);
+      }
+    }
+    for(const auto& component: coils)
+    {
+      stamp(component.stamp, steady_state ? COIL_STEADY_STATE_CONDUCTANCE : component.conductance);
+    }
+    for(const auto& opamp: opamps)
+    {
+      if(opamp.plus.type == PinType::Dynamic)
+      {
+        jacobian.coeffRef(opamp.output.index, opamp.plus.index) += 1;
+      }
+      if(opamp.minus.type == PinType::Dynamic)
+      {
+        jacobian.coeffRef(opamp.output.index, opamp.minus.index) -= 1;
+      }
+    }
+    linear_jacobians[steady_state].assign(values, values + jacobian.nonZeros());
+  }
+
+  if(linear)
+  {
+    // The jacobian never changes
+    for(int steady_state = 0; steady_state < 2; ++steady_state)
+    {
+      std::copy(linear_jacobians[steady_state].begin(), linear_jacobians[steady_state].end(), values);
+      solvers[steady_state].factorize(jacobian);
+    }
+  }
+}
+
+gsl::index NetlistModellerFilter::get_nb_dynamic_pins() const
+{
+  return dynamic_names.size();
+}
+
+gsl::index NetlistModellerFilter::get_nb_input_pins() const
+{
+  return input_names.size();
+}
+
+gsl::index NetlistModellerFilter::get_nb_static_pins() const
+{
+  return static_names.size();
+}
+
+Eigen::Matrix<NetlistModellerFilter::DataType, Eigen::Dynamic, 1> NetlistModellerFilter::get_static_state() const
+{
+  return static_state;
+}
+
+gsl::index NetlistModellerFilter::get_nb_components() const
+{
+  return resistors.size() + capacitors.size() + coils.size() + potentiometers.size() + diodes.size()
+       + transistors.size() + opamps.size();
+}
+
+std::string NetlistModellerFilter::get_dynamic_pin_name(gsl::index identifier) const
+{
+  if(identifier < 0 || identifier >= static_cast<gsl::index>(dynamic_names.size()))
+  {
+    throw ATK::RuntimeError("No such pin");
+  }
+  return dynamic_names[identifier];
+}
+
+std::string NetlistModellerFilter::get_input_pin_name(gsl::index identifier) const
+{
+  if(identifier < 0 || identifier >= static_cast<gsl::index>(input_names.size()))
+  {
+    throw ATK::RuntimeError("No such pin");
+  }
+  return input_names[identifier];
+}
+
+std::string NetlistModellerFilter::get_static_pin_name(gsl::index identifier) const
+{
+  if(identifier < 0 || identifier >= static_cast<gsl::index>(static_names.size()))
+  {
+    throw ATK::RuntimeError("No such pin");
+  }
+  return static_names[identifier];
+}
+
+gsl::index NetlistModellerFilter::get_number_parameters() const
+{
+  return potentiometers.size();
+}
+
+std::string NetlistModellerFilter::get_parameter_name(gsl::index identifier) const
+{
+  if(identifier < 0 || identifier >= static_cast<gsl::index>(potentiometers.size()))
+  {
+    throw ATK::RuntimeError("No such pin");
+  }
+  return potentiometers[identifier].name;
+}
+
+NetlistModellerFilter::DataType NetlistModellerFilter::get_parameter(gsl::index identifier) const
+{
+  if(identifier < 0 || identifier >= static_cast<gsl::index>(potentiometers.size()))
+  {
+    throw ATK::RuntimeError("No such pin");
+  }
+  return potentiometers[identifier].trimmer;
+}
+
+void NetlistModellerFilter::set_parameter(gsl::index identifier, DataType value)
+{
+  if(identifier < 0 || identifier >= static_cast<gsl::index>(potentiometers.size()))
+  {
+    throw ATK::RuntimeError("No such pin");
+  }
+  potentiometers[identifier].trimmer = value;
+  if(initialized_sampling_rate != 0)
+  {
+    stamp_linear();
+  }
+}
+
+gsl::index NetlistModellerFilter::get_nb_iterations() const
+{
+  return nb_iterations;
+}
+
+void NetlistModellerFilter::setup()
+{
+  assert(input_sampling_rate == output_sampling_rate);
+  Parent::setup();
+  if(input_sampling_rate == 0 || input_sampling_rate == initialized_sampling_rate)
+  {
+    return;
+  }
+
+  const DataType step = 1. / input_sampling_rate;
+  for(auto& component: capacitors)
+  {
+    component.conductance = 2 * component.capacitance / step;
+  }
+  for(auto& component: coils)
+  {
+    component.conductance = step / (2 * component.inductance);
+  }
+  initialized_sampling_rate = input_sampling_rate;
+  stamp_linear();
+
+  // The companion models depend on the sampling rate, so the chain settles again from its steady state
+  dynamic_state.setZero();
+  input_state.setZero();
+  const auto target_static_state = static_state;
+  for(gsl::index i = 0; i < INIT_WARMUP; ++i)
+  {
+    static_state = target_static_state * ((i + 1.) / INIT_WARMUP);
+    init();
+  }
+  static_state = target_static_state;
+  nb_iterations = 0;
+}
+
+void NetlistModellerFilter::init()
+{
+  solve<true>();
+  // In steady state, no current goes through the capacitors and there is no voltage across the coils
+  for(auto& component: capacitors)
+  {
+    component.history = component.conductance * (voltage(component.a) - voltage(component.b));
+  }
+  for(auto& component: coils)
+  {
+    const DataType v = voltage(component.a) - voltage(component.b);
+    component.history = COIL_STEADY_STATE_CONDUCTANCE * v + component.conductance * v;
+  }
+}
+
+void NetlistModellerFilter::process_impl(gsl::index size) const
+{
+  for(gsl::index i = 0; i < size; ++i)
+  {
+    for(gsl::index j = 0; j < nb_input_ports; ++j)
+    {
+      input_state[j] = converted_inputs[j][i];
+    }
+
+    solve<false>();
+
+    // Update state
+    for(const auto& component: capacitors)
+    {
+      const DataType v = voltage(component.a) - voltage(component.b);
+      component.history = 2 * component.conductance * v - component.history;
+    }
+    for(const auto& component: coils)
+    {
+      const DataType v = voltage(component.a) - voltage(component.b);
+      component.history += 2 * component.conductance * v;
+    }
+    for(gsl::index j = 0; j < nb_output_ports; ++j)
+    {
+      outputs[j][i] = dynamic_state[j];
+    }
+  }
+}
+
+NetlistModellerFilter::DataType NetlistModellerFilter::voltage(const Pin& pin) const
+{
+  switch(pin.type)
+  {
+  case PinType::Static:
+    return static_state[pin.index];
+  case PinType::Input:
+    return input_state[pin.index];
+  default:
+    return dynamic_state[pin.index];
+  }
+}
+
+void NetlistModellerFilter::add_current(const TwoPins& component, DataType current) const
+{
+  // eqs holds the currents leaving each pin
+  if(component.a.type == PinType::Dynamic && kirchhoff[component.a.index])
+  {
+    eqs[component.a.index] += current;
+  }
+  if(component.b.type == PinType::Dynamic && kirchhoff[component.b.index])
+  {
+    eqs[component.b.index] -= current;
+  }
+}
+
+template<bool steady_state>
+void NetlistModellerFilter::solve() const
+{
+  gsl::index iteration = 0;
+
+  // A linear netlist is solved exactly by the first iteration
+  gsl::index current_max_iter = linear ? 1 : MAX_ITERATION;
+  if constexpr(steady_state)
+  {
+    current_max_iter = MAX_ITERATION_STEADY_STATE;
+  }
+
+  while(iteration < current_max_iter && !iterate<steady_state>())
+  {
+    ++iteration;
+  }
+}
+
+template<bool steady_state>
+bool NetlistModellerFilter::iterate() const
+{
+  ++nb_iterations;
+  DataType* values = jacobian.valuePtr();
+  if(!linear)
+  {
+    std::copy(linear_jacobians[steady_state].begin(), linear_jacobians[steady_state].end(), values);
+  }
+
+  eqs.setZero();
+  for(const auto& component: resistors)
+  {
+    add_current(component, component.conductance * (voltage(component.a) - voltage(component.b)));
+  }
+  for(const auto& component: potentiometers)
+  {
+    if(component.trimmer != 0)
+    {
+      add_current(component.first,
+          (voltage(component.first.a) - voltage(component.first.b)) / (component.trimmer * component.resistance));
+    }
+    if(component.trimmer != 1)
+    {
+      add_current(component.second,
+          (voltage(component.second.a) - voltage(component.second.b))
+              / ((1 - component.trimmer) * component.resistance));
+    }
+  }
+  if constexpr(!steady_state)
+  {
+    for(const auto& component: capacitors)
+    {
+      add_current(component, component.conductance * (voltage(component.a) - voltage(component.b)) - component.history);
+    }
+  }
+  for(const auto& component: coils)
+  {
+    const DataType v = voltage(component.a) - voltage(component.b);
+    add_current(component,
+        steady_state ? COIL_STEADY_STATE_CONDUCTANCE * v : component.conductance * v + component.history);
+  }
+  for(const auto& opamp: opamps)
+  {
+    eqs[opamp.output.index] = voltage(opamp.plus) - voltage(opamp.minus);
+  }
+  for(const auto& component: diodes)
+  {
+    const DataType exponential = std::exp((voltage(component.a) - voltage(component.b)) / component.thermal);
+    add_current(component, component.saturation * (exponential - 1));
+    const DataType gradient = component.saturation * exponential / component.thermal;
+    for(std::size_t i = 0; i < component.stamp.size(); ++i)
+    {
+      if(component.stamp[i] >= 0)
+      {
+        values[component.stamp[i]] += (i == 0 || i == 3) ? gradient : -gradient;
+      }
+    }
+  }
+  for(const auto& component: transistors)
+  {
+    const DataType base = voltage(component.pins[1]);
+    const DataType ebe = std::exp((base - voltage(component.pins[2])) / component.thermal);
+    const DataType ebc = std::exp((base - voltage(component.pins[0])) / component.thermal);
+    const DataType ic = component.saturation * (ebe - ebc) - component.saturation / component.reverse * (ebc - 1);
+    const DataType ib
+        = component.saturation / component.forward * (ebe - 1) + component.saturation / component.reverse * (ebc - 1);
+    const DataType ic_vbe = component.saturation * ebe / component.thermal;
+    const DataType ic_vbc = -component.saturation * ebc / component.thermal * (1 + 1 / component.reverse);
+    const DataType ib_vbe = component.saturation / component.forward * ebe / component.thermal;
+    const DataType ib_vbc = component.saturation / component.reverse * ebc / component.thermal;
+
+    // Currents leaving the collector, base and emitter pins into the transistor, and their derivatives with respect to
+    // Vc, Vb and Ve
+    const std::array<DataType, 3> currents{{ic, ib, -ic - ib}};
+    const std::array<DataType, 9> gradients{{-ic_vbc,
+        ic_vbe + ic_vbc,
+        -ic_vbe,
+        -ib_vbc,
+        ib_vbe + ib_vbc,
+        -ib_vbe,
+        ic_vbc + ib_vbc,
+        -ic_vbe - ic_vbc - ib_vbe - ib_vbc,
+        ic_vbe + ib_vbe}};
+    for(std::size_t row = 0; row < 3; ++row)
+    {
+      const auto& pin = component.pins[row];
+      if(pin.type == PinType::Dynamic && kirchhoff[pin.index])
+      {
+        eqs[pin.index] += currents[row];
+      }
+    }
+    for(std::size_t i = 0; i < component.stamp.size(); ++i)
+    {
+      if(component.stamp[i] >= 0)
+      {
+        values[component.stamp[i]] += gradients[i];
+      }
+    }
+  }
+
+  // Check if the equations have converged
+  if((eqs.array().abs() < EPS).all())
+  {
+    return true;
+  }
+
+  auto& solver = solvers[steady_state];
+  if(!linear)
+  {
+    solver.factorize(jacobian);
+  }
+  delta = solver.solve(eqs);
+
+  // Check if the update is big enough
+  if(delta.hasNaN() || (delta.array().abs() < EPS).all())
+  {
+    return true;
+  }
+
+  // Big variations are only in steady state mode
+  if constexpr(steady_state)
+  {
+    auto max_delta = delta.array().abs().maxCoeff();
+    if(max_delta > MAX_DELTA)
+    {
+      delta *= MAX_DELTA / max_delta;
+    }
+  }
+
+  dynamic_state -= delta;
+
+  return false;
+}
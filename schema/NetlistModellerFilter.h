@@ -0,0 +1,199 @@
+/**
+ * \file NetlistModellerFilter.h
+ */
+
+#ifndef NETLIST_MODELLER_FILTER
+#define NETLIST_MODELLER_FILTER
+
+#include <ATK/Modelling/ModellerFilter.h>
+
+#include <Eigen/Sparse>
+#include <Eigen/SparseLU>
+
+#include <array>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// ModellerFilter built at runtime from a netlist, instead of being generated by ATKModellingGenerator
+/**
+ * The netlist uses the subset of SPICE of the schema files: resistors, capacitors, coils, diodes and npn Ebers-Moll
+ * transistors with their .model lines, potentiometers (first end, second end, wiper, value) that are parameters,
+ * ideal opamps (Z with V-, V+, Vout), and voltage sources to the ground, the DC ones being static pins and the AC
+ * ones input pins. All other nodes are dynamic pins, in the order of the netlist.
+ *
+ * Each sample is solved with Newton iterations on the nodal equations, with the same integration, convergence
+ * criteria and steady state initialization as the generated stages. The jacobian is a sparse matrix whose pattern is
+ * analyzed once. The linear components are stamped once per sampling rate or parameter change, and only the diodes
+ * and transistors are stamped in the iterations. A netlist without them is factorized once, and each sample is a
+ * single substitution.
+ * The sparse factorization allocates, so this filter is meant for voicing work, not for a release build.
+ */
+class NetlistModellerFilter final: public ATK::ModellerFilter<double>
+{
+protected:
+  using Parent = ATK::ModellerFilter<double>;
+  using typename Parent::DataType;
+  using Parent::converted_inputs;
+  using Parent::input_sampling_rate;
+  using Parent::nb_input_ports;
+  using Parent::nb_output_ports;
+  using Parent::output_sampling_rate;
+  using Parent::outputs;
+
+public:
+  /// Parses a netlist, throws ATK::RuntimeError if it can't be simulated
+  explicit NetlistModellerFilter(std::istream& netlist);
+  ~NetlistModellerFilter() override;
+
+  /// Parses the netlist in filename
+  static std::unique_ptr<NetlistModellerFilter> load(const std::string& filename);
+
+  gsl::index get_nb_dynamic_pins() const override;
+  gsl::index get_nb_input_pins() const override;
+  gsl::index get_nb_static_pins() const override;
+  Eigen::Matrix<DataType, Eigen::Dynamic, 1> get_static_state() const override;
+  gsl::index get_nb_components() const override;
+  std::string get_dynamic_pin_name(gsl::index identifier) const override;
+  std::string get_input_pin_name(gsl::index identifier) const override;
+  std::string get_static_pin_name(gsl::index identifier) const override;
+
+  /// The parameters are the potentiometers, named after them in lower case
+  gsl::index get_number_parameters() const override;
+  std::string get_parameter_name(gsl::index identifier) const override;
+  DataType get_parameter(gsl::index identifier) const override;
+  void set_parameter(gsl::index identifier, DataType value) override;
+
+  /// Returns the number of Newton iterations since the filter was set up, to compare with the generated stages
+  gsl::index get_nb_iterations() const;
+
+protected:
+  void setup() override;
+  void process_impl(gsl::index size) const override;
+
+private:
+  enum class PinType
+  {
+    Static,
+    Input,
+    Dynamic
+  };
+
+  struct Pin
+  {
+    PinType type;
+    gsl::index index;
+  };
+
+  /// Positions of the entries of a two pin component in the values of the jacobian, -1 for the ones that don't exist
+  using Stamp = std::array<gsl::index, 4>;
+
+  struct TwoPins
+  {
+    Pin a;
+    Pin b;
+    Stamp stamp;
+  };
+
+  struct Resistor: TwoPins
+  {
+    DataType conductance;
+  };
+
+  /// Trapezoidal companion model, the current is conductance * v - history
+  struct Capacitor: TwoPins
+  {
+    DataType capacitance;
+    DataType conductance{0};
+    mutable DataType history{0};
+  };
+
+  /// Trapezoidal companion model, the current is conductance * v + history
+  struct Coil: TwoPins
+  {
+    DataType inductance;
+    DataType conductance{0};
+    mutable DataType history{0};
+  };
+
+  struct Potentiometer
+  {
+    TwoPins first;
+    TwoPins second;
+    DataType resistance;
+    std::string name;
+    DataType trimmer{0};
+  };
+
+  struct Diode: TwoPins
+  {
+    DataType saturation;
+    DataType thermal;
+  };
+
+  struct Transistor
+  {
+    /// Collector, base, emitter
+    std::array<Pin, 3> pins;
+    /// Entries for the rows and columns in the order of the pins
+    std::array<gsl::index, 9> stamp;
+    DataType saturation;
+    DataType thermal;
+    DataType forward;
+    DataType reverse;
+  };
+
+  struct Opamp
+  {
+    Pin minus;
+    Pin plus;
+    Pin output;
+  };
+
+  void parse(std::istream& netlist);
+  Pin get_pin(const std::string& name);
+  void build_pattern();
+  void stamp_linear();
+  void init();
+
+  DataType voltage(const Pin& pin) const;
+  void add_current(const TwoPins& component, DataType current) const;
+  template<bool steady_state>
+  void solve() const;
+  template<bool steady_state>
+  bool iterate() const;
+
+  std::vector<std::string> static_names{"0"};
+  std::vector<std::string> input_names;
+  std::vector<std::string> dynamic_names;
+  std::vector<DataType> static_values{0};
+  /// False for the dynamic pins that are opamp outputs, whose equation is the opamp one
+  std::vector<bool> kirchhoff;
+
+  std::vector<Resistor> resistors;
+  std::vector<Capacitor> capacitors;
+  std::vector<Coil> coils;
+  std::vector<Potentiometer> potentiometers;
+  std::vector<Diode> diodes;
+  std::vector<Transistor> transistors;
+  std::vector<Opamp> opamps;
+  /// True without diodes and transistors, the jacobian is then constant
+  bool linear{true};
+
+  Eigen::Matrix<DataType, Eigen::Dynamic, 1> static_state;
+  mutable Eigen::Matrix<DataType, Eigen::Dynamic, 1> input_state;
+  mutable Eigen::Matrix<DataType, Eigen::Dynamic, 1> dynamic_state;
+  mutable Eigen::Matrix<DataType, Eigen::Dynamic, 1> eqs;
+  mutable Eigen::Matrix<DataType, Eigen::Dynamic, 1> delta;
+
+  /// Jacobian values of the linear components, in steady state and not
+  std::array<std::vector<DataType>, 2> linear_jacobians;
+  mutable Eigen::SparseMatrix<DataType> jacobian;
+  mutable std::array<Eigen::SparseLU<Eigen::SparseMatrix<DataType>>, 2> solvers;
+
+  mutable gsl::index nb_iterations{0};
+  gsl::index initialized_sampling_rate{0};
+};
+
+#endif
@@ -0,0 +1,67 @@
+/**
+ * \file ParallelJobs.h
+ * Pool of threads of the characterization tools
+ */
+
+#ifndef SCHEMA_PARALLEL_JOBS
+#define SCHEMA_PARALLEL_JOBS
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Number of threads from an optional command line argument, one per core by default
+inline unsigned int nb_threads(int argc, const char** argv, int index)
+{
+  return argc > index ? std::max(1, std::stoi(argv[index])) : std::max(1u, std::thread::hardware_concurrency());
+}
+
+/// Runs job(0) to job(nb_jobs - 1) on nb_threads threads, each thread taking the next job when it is done
+/**
+ * job returns a line for the log, printed once the job is done. The exceptions of a job are printed and don't stop
+ * the other jobs.
+ * @return true if all the jobs succeeded
+ */
+template<typename Job>
+bool run_parallel(size_t nb_jobs, unsigned int nb_threads, Job job)
+{
+  std::atomic<size_t> next_job{0};
+  std::atomic<bool> failed{false};
+  std::mutex log;
+
+  auto worker = [&]() {
+    for(size_t index = next_job++; index < nb_jobs; index = next_job++)
+    {
+      try
+      {
+        const std::string line = job(index);
+        std::lock_guard<std::mutex> lock(log);
+        std::cout << line << std::endl;
+      }
+      catch(const std::exception& e)
+      {
+        std::lock_guard<std::mutex> lock(log);
+        std::cerr << "Job " << index << ": " << e.what() << std::endl;
+        failed = true;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for(size_t i = 0; i < std::min<size_t>(nb_threads, nb_jobs); ++i)
+  {
+    threads.emplace_back(worker);
+  }
+  for(auto& thread : threads)
+  {
+    thread.join();
+  }
+  return !failed;
+}
+
+#endif
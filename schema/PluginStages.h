@@ -0,0 +1,79 @@
+/**
+ * \file PluginStages.h
+ */
+
+#ifndef PLUGIN_STAGES
+#define PLUGIN_STAGES
+
+#include <ATK/Core/TypedBaseFilter.h>
+#include <ATK/Modelling/ModellerFilter.h>
+
+#include <array>
+#include <memory>
+
+// Both static_elements.h use the same include guard, so the tools that link the stages of both plugins declare them here
+namespace MT2
+{
+std::unique_ptr<ATK::ModellerFilter<double>> createStaticFilter_stage1();
+std::unique_ptr<ATK::ModellerFilter<double>> createStaticFilter_stage2();
+std::unique_ptr<ATK::ModellerFilter<double>> createStaticFilter_stage3();
+std::unique_ptr<ATK::ModellerFilter<double>> createStaticFilter_stage4();
+std::unique_ptr<ATK::ModellerFilter<double>> createStaticFilter_stage5();
+std::unique_ptr<ATK::ModellerFilter<double>> createStaticFilter_stage6();
+std::unique_ptr<ATK::TypedBaseFilter<double>> createStaticFilter_stage2_eco();
+std::unique_ptr<ATK::TypedBaseFilter<double>> createStaticFilter_stage6_eco();
+} // namespace MT2
+
+namespace MTB
+{
+std::unique_ptr<ATK::ModellerFilter<double>> createStaticFilter_stage1();
+std::unique_ptr<ATK::ModellerFilter<double>> createStaticFilter_stage2();
+std::unique_ptr<ATK::ModellerFilter<double>> createStaticFilter_stage3();
+std::unique_ptr<ATK::ModellerFilter<double>> createStaticFilter_stage4();
+std::unique_ptr<ATK::ModellerFilter<double>> createStaticFilter_stage5();
+std::unique_ptr<ATK::ModellerFilter<double>> createStaticFilter_stage6();
+std::unique_ptr<ATK::TypedBaseFilter<double>> createStaticFilter_stage2_eco();
+std::unique_ptr<ATK::TypedBaseFilter<double>> createStaticFilter_stage6_eco();
+} // namespace MTB
+
+using StageFactory = std::unique_ptr<ATK::ModellerFilter<double>> (*)();
+
+/// Netlists of the stages, stage N being STAGE_NAMES[N - 1]
+inline const std::array<const char*, 6> STAGE_NAMES{"01-high-pass",
+    "02-pre-distortion-tone-shaping",
+    "03-band-pass",
+    "04-dist-level",
+    "05-dist",
+    "06-post-distortion-tone-shaping"};
+
+/// The six stages of a plugin, stage N being stages[N - 1]
+struct PluginStages
+{
+  const char* name;
+  std::array<StageFactory, 6> stages;
+};
+
+inline const std::array<PluginStages, 2> PLUGINS{{
+    {"MT2",
+        {MT2::createStaticFilter_stage1,
+            MT2::createStaticFilter_stage2,
+            MT2::createStaticFilter_stage3,
+            MT2::createStaticFilter_stage4,
+            MT2::createStaticFilter_stage5,
+            MT2::createStaticFilter_stage6}},
+    {"MTB",
+        {MTB::createStaticFilter_stage1,
+            MTB::createStaticFilter_stage2,
+            MTB::createStaticFilter_stage3,
+            MTB::createStaticFilter_stage4,
+            MTB::createStaticFilter_stage5,
+            MTB::createStaticFilter_stage6}},
+}};
+
+/// Stage 4 parameter for a distLevel in %, the mapping of ProcessingChain::setParameters()
+inline double dist_level_parameter(double dist_level)
+{
+  return dist_level * .99 / 100 + .05;
+}
+
+#endif
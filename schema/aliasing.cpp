@@ -0,0 +1,301 @@
+#include "../MT2/Source/LinearPhaseDecimationFilter.h"
+#include "FFT.h"
+#include "ParallelJobs.h"
+#include "PluginStages.h"
+
+#include <ATK/Core/InPointerFilter.h>
+#include <ATK/Core/OutPointerFilter.h>
+#include <ATK/EQ/ButterworthFilter.h>
+#include <ATK/EQ/IIRFilter.h>
+#include <ATK/Modelling/ModellerFilter.h>
+#include <ATK/Tools/DecimationFilter.h>
+#include <ATK/Tools/OversamplingFilter.h>
+
+#include <boost/math/constants/constants.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+constexpr size_t SAMPLING_RATE = 48000;
+/// Analysis window, in host samples, the tones are periodic in it so that no window function is needed
+constexpr size_t ANALYSIS_SIZE = 32768;
+constexpr size_t WARMUP_SIZE = 8192;
+constexpr gsl::index BLOCK_SIZE = 1024;
+
+constexpr std::array<size_t, 4> OVERSAMPLINGS{2, 4, 8, 16};
+constexpr std::array<double, 5> FREQUENCIES{2000, 5000, 8000, 12000, 16000};
+constexpr std::array<double, 3> LEVELS{-20, -6, 0};
+/// distLevel of the plugin, in %
+constexpr std::array<double, 3> DIST_LEVELS{0, 50, 100};
+
+/// Lowpass before the decimation, the first one is the minimum phase path of the plugin, the last its linear phase
+enum class Decimation
+{
+  Butterworth6,
+  Butterworth10,
+  LinearPhase
+};
+constexpr std::array<Decimation, 3> DECIMATIONS{
+    Decimation::Butterworth6, Decimation::Butterworth10, Decimation::LinearPhase};
+
+const char* decimation_name(Decimation decimation)
+{
+  switch(decimation)
+  {
+  case Decimation::Butterworth6:
+    return "butterworth6";
+  case Decimation::Butterworth10:
+    return "butterworth10";
+  default:
+    return "linear-phase";
+  }
+}
+
+std::unique_ptr<ATK::BaseFilter> make_oversampling(size_t oversampling)
+{
+  switch(oversampling)
+  {
+  case 2:
+    return std::make_unique<ATK::OversamplingFilter<double, ATK::Oversampling6points5order_2<double>>>();
+  case 4:
+    return std::make_unique<ATK::OversamplingFilter<double, ATK::Oversampling6points5order_4<double>>>();
+  case 8:
+    return std::make_unique<ATK::OversamplingFilter<double, ATK::Oversampling6points5order_8<double>>>();
+  default:
+    return std::make_unique<ATK::OversamplingFilter<double, ATK::Oversampling6points5order_16<double>>>();
+  }
+}
+
+bool is_prime(size_t value)
+{
+  for(size_t divisor = 2; divisor * divisor <= value; ++divisor)
+  {
+    if(value % divisor == 0)
+    {
+      return false;
+    }
+  }
+  return value > 1;
+}
+
+/// Bin of the analysis window closest to frequency, prime so that the aliases fall between the harmonics
+size_t tone_bin(double frequency)
+{
+  auto bin = static_cast<size_t>(std::round(frequency * ANALYSIS_SIZE / SAMPLING_RATE));
+  for(size_t offset = 0;; ++offset)
+  {
+    if(is_prime(bin - offset))
+    {
+      return bin - offset;
+    }
+    if(is_prime(bin + offset))
+    {
+      return bin + offset;
+    }
+  }
+}
+
+struct Job
+{
+  const PluginStages* plugin;
+  size_t oversampling;
+  Decimation decimation;
+  double dist_level;
+};
+
+/// The stages of the plugin with an oversampling factor and a decimation, the tone stack is linear and left out
+std::vector<double> run_chain(const Job& job, const std::vector<double>& input)
+{
+  const size_t oversampled_rate = SAMPLING_RATE * job.oversampling;
+  std::vector<double> output(input.size());
+  std::array<std::unique_ptr<ATK::ModellerFilter<double>>, 6> stages;
+  for(size_t i = 0; i < stages.size(); ++i)
+  {
+    stages[i] = job.plugin->stages[i]();
+  }
+  stages[3]->set_parameter(0, dist_level_parameter(job.dist_level));
+
+  ATK::InPointerFilter<double> generator(input.data(), 1, input.size(), false);
+  generator.set_output_sampling_rate(SAMPLING_RATE);
+  stages[0]->set_input_sampling_rate(SAMPLING_RATE);
+  stages[0]->set_output_sampling_rate(SAMPLING_RATE);
+  stages[0]->set_input_port(stages[0]->find_input_pin("vin"), &generator, 0);
+
+  std::unique_ptr<ATK::BaseFilter> oversampling = make_oversampling(job.oversampling);
+  oversampling->set_input_sampling_rate(SAMPLING_RATE);
+  oversampling->set_output_sampling_rate(oversampled_rate);
+  oversampling->set_input_port(0, stages[0].get(), stages[0]->find_dynamic_pin("vout"));
+  ATK::BaseFilter* previous = oversampling.get();
+  gsl::index previous_port = 0;
+  for(size_t i = 1; i < stages.size(); ++i)
+  {
+    stages[i]->set_input_sampling_rate(oversampled_rate);
+    stages[i]->set_output_sampling_rate(oversampled_rate);
+    stages[i]->set_input_port(stages[i]->find_input_pin("vin"), previous, previous_port);
+    previous = stages[i].get();
+    previous_port = stages[i]->find_dynamic_pin("vout");
+  }
+
+  ATK::IIRFilter<ATK::ButterworthLowPassCoefficients<double>> lowpass;
+  ATK::DecimationFilter<double> decimation;
+  MT2::LinearPhaseDecimationFilter linear_phase_decimation;
+  ATK::BaseFilter* last = &decimation;
+  if(job.decimation == Decimation::LinearPhase)
+  {
+    linear_phase_decimation.set_input_sampling_rate(oversampled_rate);
+    linear_phase_decimation.set_output_sampling_rate(SAMPLING_RATE);
+    linear_phase_decimation.set_passband(20000);
+    linear_phase_decimation.set_input_port(0, previous, previous_port);
+    last = &linear_phase_decimation;
+  }
+  else
+  {
+    lowpass.set_input_sampling_rate(oversampled_rate);
+    lowpass.set_output_sampling_rate(oversampled_rate);
+    lowpass.set_cut_frequency(20000);
+    lowpass.set_order(job.decimation == Decimation::Butterworth6 ? 6 : 10);
+    lowpass.set_input_port(0, previous, previous_port);
+    decimation.set_input_sampling_rate(oversampled_rate);
+    decimation.set_output_sampling_rate(SAMPLING_RATE);
+    decimation.set_input_port(0, &lowpass, 0);
+  }
+
+  ATK::OutPointerFilter<double> sink(output.data(), 1, output.size(), false);
+  sink.set_input_sampling_rate(SAMPLING_RATE);
+  sink.set_input_port(0, last, 0);
+  for(size_t i = 0; i < output.size(); i += BLOCK_SIZE)
+  {
+    sink.process(std::min<gsl::index>(BLOCK_SIZE, output.size() - i));
+  }
+  return output;
+}
+
+struct Aliasing
+{
+  /// Energy of the harmonics below Nyquist, relative to the fundamental, in dB
+  double thd_db;
+  /// Energy of everything else but DC, relative to the fundamental, in dB
+  double alias_db;
+  /// Largest component that is not a harmonic, relative to the fundamental, in dB
+  double max_alias_db;
+  double max_alias_frequency;
+};
+
+Aliasing measure(const std::vector<double>& output, size_t bin)
+{
+  std::vector<std::complex<double>> data(output.end() - ANALYSIS_SIZE, output.end());
+  fft(data);
+  const double fundamental = std::norm(data[bin]);
+  double harmonics = 0;
+  double aliases = 0;
+  double max_alias = 0;
+  size_t max_alias_bin = 0;
+  for(size_t i = 1; i <= ANALYSIS_SIZE / 2; ++i)
+  {
+    if(i == bin)
+    {
+      continue;
+    }
+    const double energy = std::norm(data[i]);
+    if(i % bin == 0)
+    {
+      harmonics += energy;
+    }
+    else
+    {
+      aliases += energy;
+      if(energy > max_alias)
+      {
+        max_alias = energy;
+        max_alias_bin = i;
+      }
+    }
+  }
+  return {10 * std::log10(harmonics / fundamental),
+      10 * std::log10(aliases / fundamental),
+      10 * std::log10(max_alias / fundamental),
+      static_cast<double>(max_alias_bin) * SAMPLING_RATE / ANALYSIS_SIZE};
+}
+
+/// Runs every tone of a job, returning the lines of the results
+std::string run(const Job& job)
+{
+  const double pi = boost::math::constants::pi<double>();
+  std::ostringstream lines;
+  for(double frequency : FREQUENCIES)
+  {
+    const size_t bin = tone_bin(frequency);
+    for(double level : LEVELS)
+    {
+      std::vector<double> input(WARMUP_SIZE + ANALYSIS_SIZE);
+      for(size_t i = 0; i < input.size(); ++i)
+      {
+        input[i] = std::pow(10, level / 20) * std::sin(2 * pi * bin * i / ANALYSIS_SIZE);
+      }
+      const Aliasing aliasing = measure(run_chain(job, input), bin);
+      lines << job.plugin->name << "," << job.oversampling << "," << decimation_name(job.decimation) << ","
+            << static_cast<double>(bin) * SAMPLING_RATE / ANALYSIS_SIZE << "," << level << "," << job.dist_level
+            << "," << aliasing.alias_db << "," << aliasing.max_alias_db << "," << aliasing.max_alias_frequency << ","
+            << aliasing.thd_db << "\n";
+    }
+  }
+  return lines.str();
+}
+} // namespace
+
+/// Measures the aliasing of the chains of MT2 and MTB for each oversampling factor and decimation lowpass
+/**
+ * Usage: aliasing.exe results.csv [threads]
+ * The chains run at 48 kHz on full scale, -6 dB and -20 dB tones from 2 kHz to 16 kHz, for several distLevel values,
+ * with 2x to 16x oversampling, and with the Butterworth lowpass of the minimum phase path of the plugin, a steeper
+ * one, or its linear phase decimation. The tones are on a prime bin of the analysis window, so that their harmonics
+ * folded back around the sampling frequency don't fall on a harmonic below Nyquist. Everything that isn't DC, the
+ * tone or one of its harmonics is counted as aliasing, relative to the tone. The jobs run in parallel, one thread per
+ * core by default.
+ */
+int main(int argc, const char** argv)
+{
+  std::vector<Job> jobs;
+  for(const auto& plugin : PLUGINS)
+  {
+    for(size_t oversampling : OVERSAMPLINGS)
+    {
+      for(Decimation decimation : DECIMATIONS)
+      {
+        for(double dist_level : DIST_LEVELS)
+        {
+          jobs.push_back({&plugin, oversampling, decimation, dist_level});
+        }
+      }
+    }
+  }
+
+  std::vector<std::string> results(jobs.size());
+  const bool succeeded = run_parallel(jobs.size(), nb_threads(argc, argv, 2), [&](size_t job) {
+    results[job] = run(jobs[job]);
+    std::ostringstream line;
+    line << jobs[job].plugin->name << " x" << jobs[job].oversampling << " " << decimation_name(jobs[job].decimation)
+         << " dist " << jobs[job].dist_level;
+    return line.str();
+  });
+
+  std::ofstream out(argv[1]);
+  out << "plugin,oversampling,decimation,frequency,level_db,dist_level,alias_db,max_alias_db,max_alias_frequency,"
+         "thd_db"
+      << std::endl;
+  for(const auto& result : results)
+  {
+    out << result;
+  }
+  return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
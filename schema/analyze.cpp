@@ -0,0 +1,360 @@
+#include "FFT.h"
+#include "ParallelJobs.h"
+#include "PluginStages.h"
+
+#include <ATK/Core/InPointerFilter.h>
+#include <ATK/Core/OutPointerFilter.h>
+#include <ATK/EQ/ButterworthFilter.h>
+#include <ATK/EQ/IIRFilter.h>
+#include <ATK/Modelling/ModellerFilter.h>
+#include <ATK/Tools/DecimationFilter.h>
+#include <ATK/Tools/OversamplingFilter.h>
+
+#include <boost/math/constants/constants.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+constexpr size_t SAMPLING_RATE = 48000;
+constexpr size_t OVERSAMPLING = 8;
+constexpr double START_FREQUENCY = 20;
+constexpr double END_FREQUENCY = 20000;
+/// Approximate duration of the sweep, in s
+constexpr double DURATION = 2.5;
+constexpr size_t NB_HARMONICS = 5;
+constexpr gsl::index BLOCK_SIZE = 1024;
+/// distLevel of the plugin, in %
+constexpr std::array<double, 5> DIST_LEVELS{0, 25, 50, 75, 100};
+
+/// Exponential sine sweep, synchronized so that the harmonic responses have the right phases
+struct Sweep
+{
+  size_t sampling_rate;
+  /// Time for the instantaneous frequency to be multiplied by e, in s
+  double rate;
+  std::vector<double> signal;
+  /// Time reversed sweep with a 6 dB/octave slope, the deconvolution filter of the sweep
+  std::vector<double> inverse;
+
+  Sweep(size_t sampling_rate, double level)
+    : sampling_rate(sampling_rate)
+  {
+    const double pi = boost::math::constants::pi<double>();
+    const double log_ratio = std::log(END_FREQUENCY / START_FREQUENCY);
+    rate = std::round(START_FREQUENCY * DURATION / log_ratio) / START_FREQUENCY;
+    const auto size = static_cast<size_t>(rate * log_ratio * sampling_rate);
+    signal.resize(size);
+    inverse.resize(size);
+    for(size_t i = 0; i < size; ++i)
+    {
+      const double t = static_cast<double>(i) / sampling_rate;
+      signal[i] = level * std::sin(2 * pi * START_FREQUENCY * rate * (std::exp(t / rate) - 1));
+    }
+    for(size_t i = 0; i < size; ++i)
+    {
+      inverse[i] = signal[size - 1 - i] * std::exp(-static_cast<double>(i) / sampling_rate / rate);
+    }
+  }
+
+  /// Delay of the response of the harmonic order before the linear response, in samples
+  double harmonic_delay(size_t order) const
+  {
+    return rate * std::log(static_cast<double>(order)) * sampling_rate;
+  }
+};
+
+using System = std::function<std::vector<double>(const std::vector<double>&)>;
+
+struct Job
+{
+  std::string name;
+  size_t sampling_rate;
+  System system;
+};
+
+void process(ATK::BaseFilter& sink, size_t size)
+{
+  for(size_t i = 0; i < size; i += BLOCK_SIZE)
+  {
+    sink.process(std::min<gsl::index>(BLOCK_SIZE, size - i));
+  }
+}
+
+/// A stage alone, at the sampling rate it has in the plugin
+System stage_system(StageFactory factory, gsl::index stage, size_t sampling_rate, double dist_level)
+{
+  return [=](const std::vector<double>& input) {
+    std::vector<double> output(input.size());
+    ATK::InPointerFilter<double> generator(input.data(), 1, input.size(), false);
+    generator.set_output_sampling_rate(sampling_rate);
+
+    std::unique_ptr<ATK::ModellerFilter<double>> filter = factory();
+    if(stage == 4)
+    {
+      filter->set_parameter(0, dist_level_parameter(dist_level));
+    }
+    filter->set_input_sampling_rate(sampling_rate);
+    filter->set_output_sampling_rate(sampling_rate);
+    filter->set_input_port(filter->find_input_pin("vin"), &generator, 0);
+
+    ATK::OutPointerFilter<double> sink(output.data(), 1, output.size(), false);
+    sink.set_input_sampling_rate(sampling_rate);
+    sink.set_input_port(0, filter.get(), filter->find_dynamic_pin("vout"));
+    process(sink, output.size());
+    return output;
+  };
+}
+
+/// The chain of generate_full.cpp, the stages with the oversampling and the decimation of the plugin
+System chain_system(const PluginStages& plugin, double dist_level)
+{
+  return [&plugin, dist_level](const std::vector<double>& input) {
+    std::vector<double> output(input.size());
+    std::array<std::unique_ptr<ATK::ModellerFilter<double>>, 6> stages;
+    for(size_t i = 0; i < stages.size(); ++i)
+    {
+      stages[i] = plugin.stages[i]();
+    }
+    stages[3]->set_parameter(0, dist_level_parameter(dist_level));
+
+    ATK::InPointerFilter<double> generator(input.data(), 1, input.size(), false);
+    generator.set_output_sampling_rate(SAMPLING_RATE);
+    ATK::OversamplingFilter<double, ATK::Oversampling6points5order_8<double>> oversampling;
+    ATK::IIRFilter<ATK::ButterworthLowPassCoefficients<double>> lowpass;
+    ATK::DecimationFilter<double> decimation;
+    ATK::OutPointerFilter<double> sink(output.data(), 1, output.size(), false);
+
+    stages[0]->set_input_sampling_rate(SAMPLING_RATE);
+    stages[0]->set_output_sampling_rate(SAMPLING_RATE);
+    stages[0]->set_input_port(stages[0]->find_input_pin("vin"), &generator, 0);
+    oversampling.set_input_sampling_rate(SAMPLING_RATE);
+    oversampling.set_output_sampling_rate(SAMPLING_RATE * OVERSAMPLING);
+    oversampling.set_input_port(0, stages[0].get(), stages[0]->find_dynamic_pin("vout"));
+    ATK::BaseFilter* previous = &oversampling;
+    gsl::index previous_port = 0;
+    for(size_t i = 1; i < stages.size(); ++i)
+    {
+      stages[i]->set_input_sampling_rate(SAMPLING_RATE * OVERSAMPLING);
+      stages[i]->set_output_sampling_rate(SAMPLING_RATE * OVERSAMPLING);
+      stages[i]->set_input_port(stages[i]->find_input_pin("vin"), previous, previous_port);
+      previous = stages[i].get();
+      previous_port = stages[i]->find_dynamic_pin("vout");
+    }
+    lowpass.set_input_sampling_rate(SAMPLING_RATE * OVERSAMPLING);
+    lowpass.set_output_sampling_rate(SAMPLING_RATE * OVERSAMPLING);
+    lowpass.set_cut_frequency(20000);
+    lowpass.set_order(6);
+    lowpass.set_input_port(0, previous, previous_port);
+    decimation.set_input_sampling_rate(SAMPLING_RATE * OVERSAMPLING);
+    decimation.set_output_sampling_rate(SAMPLING_RATE);
+    decimation.set_input_port(0, &lowpass, 0);
+    sink.set_input_sampling_rate(SAMPLING_RATE);
+    sink.set_input_port(0, &decimation, 0);
+    process(sink, output.size());
+    return output;
+  };
+}
+
+std::vector<Job> make_jobs()
+{
+  std::vector<Job> jobs;
+  for(const auto& plugin : PLUGINS)
+  {
+    for(gsl::index stage = 1; stage <= 6; ++stage)
+    {
+      const std::string name = std::string(plugin.name) + "-" + STAGE_NAMES[stage - 1];
+      const size_t sampling_rate = stage == 1 ? SAMPLING_RATE : SAMPLING_RATE * OVERSAMPLING;
+      if(stage == 4)
+      {
+        for(double dist_level : DIST_LEVELS)
+        {
+          jobs.push_back({name + "-dist" + std::to_string(static_cast<int>(dist_level)),
+              sampling_rate,
+              stage_system(plugin.stages[stage - 1], stage, sampling_rate, dist_level)});
+        }
+      }
+      else
+      {
+        jobs.push_back({name, sampling_rate, stage_system(plugin.stages[stage - 1], stage, sampling_rate, 0)});
+      }
+    }
+    for(double dist_level : DIST_LEVELS)
+    {
+      jobs.push_back({std::string(plugin.name) + "-chain-dist" + std::to_string(static_cast<int>(dist_level)),
+          SAMPLING_RATE,
+          chain_system(plugin, dist_level)});
+    }
+  }
+  return jobs;
+}
+
+std::vector<std::complex<double>> transform(const std::vector<double>& signal, size_t size)
+{
+  std::vector<std::complex<double>> data(size);
+  std::copy(signal.begin(), signal.end(), data.begin());
+  fft(data);
+  return data;
+}
+
+/// Response of a harmonic order, windowed around its impulse and transformed
+std::vector<std::complex<double>> harmonic_response(
+    const std::vector<std::complex<double>>& deconvolved, double position, size_t window, size_t pre_window)
+{
+  const double pi = boost::math::constants::pi<double>();
+  std::vector<std::complex<double>> response(window);
+  const auto start = static_cast<std::ptrdiff_t>(std::round(position)) - static_cast<std::ptrdiff_t>(pre_window);
+  for(size_t i = 0; i < window; ++i)
+  {
+    // Half Hann fade in on the pre window and fade out on the last quarter, against the neighbour orders
+    double gain = 1;
+    if(i < pre_window)
+    {
+      gain = .5 - .5 * std::cos(pi * i / pre_window);
+    }
+    else if(i >= window * 3 / 4)
+    {
+      gain = .5 + .5 * std::cos(pi * (i - window * 3 / 4) / (window / 4));
+    }
+    const auto index = (start + static_cast<std::ptrdiff_t>(i) + static_cast<std::ptrdiff_t>(deconvolved.size()))
+                       % static_cast<std::ptrdiff_t>(deconvolved.size());
+    response[i] = deconvolved[index].real() * gain;
+  }
+  fft(response);
+  // The impulse is at pre_window, not at 0
+  for(size_t i = 0; i < window; ++i)
+  {
+    response[i] *= std::polar(1., 2 * pi * i * pre_window / window);
+  }
+  return response;
+}
+
+/// Analyzes the response of the system to the sweep, writing prefix.csv and prefix.ir.dat
+std::string analyze(const Job& job, double level, const std::string& prefix)
+{
+  const Sweep sweep(job.sampling_rate, level);
+  const std::vector<double> output = job.system(sweep.signal);
+
+  size_t size = 1;
+  while(size < 2 * sweep.signal.size())
+  {
+    size <<= 1;
+  }
+  const auto inverse = transform(sweep.inverse, size);
+  auto deconvolved = transform(output, size);
+  const auto reference = transform(sweep.signal, size);
+
+  // The deconvolution of the sweep by itself gives the scale of a unit gain
+  double scale = 0;
+  size_t nb_bins = 0;
+  for(size_t i = size * 100 / job.sampling_rate; i < size * 10000 / job.sampling_rate; ++i, ++nb_bins)
+  {
+    scale += std::abs(reference[i] * inverse[i]);
+  }
+  scale /= nb_bins * level;
+  for(size_t i = 0; i < size; ++i)
+  {
+    deconvolved[i] *= inverse[i] / scale;
+  }
+  fft(deconvolved, true);
+
+  // The window of each order must stop before the next order, the closest being the last two
+  const double linear_position = sweep.signal.size() - 1;
+  const double spacing = sweep.harmonic_delay(NB_HARMONICS) - sweep.harmonic_delay(NB_HARMONICS - 1);
+  size_t window = 1;
+  while(window * 2 <= spacing)
+  {
+    window <<= 1;
+  }
+  const size_t pre_window = window / 16;
+  std::vector<std::vector<std::complex<double>>> responses;
+  for(size_t order = 1; order <= NB_HARMONICS; ++order)
+  {
+    responses.push_back(
+        harmonic_response(deconvolved, linear_position - sweep.harmonic_delay(order), window, pre_window));
+  }
+
+  std::ofstream impulse(prefix + ".ir.dat", std::ios::binary);
+  for(size_t i = 0; i < window; ++i)
+  {
+    const double value = deconvolved[(static_cast<size_t>(linear_position) + i) % size].real();
+    impulse.write(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  const double pi = boost::math::constants::pi<double>();
+  std::ofstream out(prefix + ".csv");
+  out << "frequency,magnitude_db,phase_deg";
+  for(size_t order = 2; order <= NB_HARMONICS; ++order)
+  {
+    out << ",h" << order << "_db";
+  }
+  out << std::endl;
+  double gain_1k = 0;
+  double thd_1k = 0;
+  for(size_t i = 1; i < window / 2; ++i)
+  {
+    const double frequency = static_cast<double>(i) * job.sampling_rate / window;
+    if(frequency < START_FREQUENCY || frequency > END_FREQUENCY)
+    {
+      continue;
+    }
+    const double fundamental = std::abs(responses[0][i]);
+    out << frequency << "," << 20 * std::log10(fundamental) << "," << std::arg(responses[0][i]) * 180 / pi;
+    double harmonics = 0;
+    for(size_t order = 2; order <= NB_HARMONICS; ++order)
+    {
+      out << ",";
+      // The harmonic of an input at frequency is at order * frequency in the response of its order
+      if(order * frequency <= END_FREQUENCY && order * i < window / 2)
+      {
+        const double harmonic = std::abs(responses[order - 1][order * i]);
+        out << 20 * std::log10(harmonic / fundamental);
+        harmonics += harmonic * harmonic;
+      }
+    }
+    out << std::endl;
+    if(gain_1k == 0 && frequency >= 1000)
+    {
+      gain_1k = 20 * std::log10(fundamental);
+      thd_1k = 100 * std::sqrt(harmonics) / fundamental;
+    }
+  }
+
+  std::ostringstream line;
+  line << job.name << ": " << gain_1k << " dB at 1 kHz, THD (up to H" << NB_HARMONICS << ") " << thd_1k << "%";
+  return line.str();
+}
+} // namespace
+
+/// Measures the frequency response and the harmonic distortion of the stages and of the chains of MT2 and MTB
+/**
+ * Usage: analyze.exe directory [level_db] [threads]
+ * Each stage, at the sampling rate it has in the plugin, and each chain at 48 kHz, is driven by an exponential sine
+ * sweep from 20 Hz to 20 kHz at level_db (0 dBFS by default). The deconvolution of the output by the inverse sweep
+ * separates the linear impulse response from the responses of the harmonics, which come before it.
+ * directory/name.csv gets the magnitude and the phase of the linear response, and the level of the harmonics 2 to 5
+ * relative to the fundamental, for each input frequency. directory/name.ir.dat gets the linear impulse response, as
+ * raw float64. The dist level stage and the chains are analyzed for several distLevel values. The jobs run in
+ * parallel, one thread per core by default.
+ */
+int main(int argc, const char** argv)
+{
+  const std::string directory = argv[1];
+  const double level = std::pow(10, (argc > 2 ? std::atof(argv[2]) : 0) / 20);
+
+  const std::vector<Job> jobs = make_jobs();
+  const bool succeeded = run_parallel(jobs.size(), nb_threads(argc, argv, 3), [&](size_t job) {
+    return analyze(jobs[job], level, directory + "/" + jobs[job].name);
+  });
+  return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
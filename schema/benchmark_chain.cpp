@@ -0,0 +1,121 @@
+#include "ProcessingChain.h"
+
+#include <boost/math/constants/constants.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// PLUGIN is the namespace of the chain, MT2 or MTB, and MID_FREQ its default mid frequency, both set by the Makefile
+#define STRINGIFY_(x) #x
+#define STRINGIFY(x) STRINGIFY_(x)
+
+namespace
+{
+constexpr std::array<long, 3> SAMPLING_RATES{44100, 48000, 96000};
+constexpr std::array<int, 9> BLOCK_SIZES{16, 32, 64, 128, 256, 512, 1024, 2048, 4096};
+/// Audio processed before measuring, so that the chain is out of its initial transient, in s
+constexpr double WARMUP = .5;
+
+struct Preset
+{
+  const char* name;
+  PLUGIN::ProcessingChain::Parameters parameters;
+};
+
+/// The default parameters and the factory programs of PluginProcessor.cpp
+constexpr std::array<Preset, 3> PRESETS{{
+    {"Default", {50.f, 0.f, 0.f, 0.f, MID_FREQ, 3.1f, .25f, 1.f}},
+    {"Minimum distortion", {0.f, 0.f, 0.f, 0.f, MID_FREQ, 3.1f, .25f, 1.f}},
+    {"Maximum damage", {100.f, 20.f, 20.f, 15.f, MID_FREQ, 3.1f, .25f, 1.f}},
+}};
+
+/// Open E power chord whose level goes up and down between -20 and -2 dB every second, it is never silent
+std::vector<float> make_signal(long sampling_rate, double duration)
+{
+  constexpr double pi = boost::math::constants::pi<double>();
+  std::vector<float> signal(static_cast<size_t>(sampling_rate * duration));
+  for(size_t i = 0; i < signal.size(); ++i)
+  {
+    const double t = static_cast<double>(i) / sampling_rate;
+    const double level = std::pow(10, (-11 + 9 * std::sin(2 * pi * t)) / 20);
+    signal[i] = static_cast<float>(
+        level * (std::sin(2 * pi * 82.41 * t) + std::sin(2 * pi * 123.47 * t) + std::sin(2 * pi * 164.81 * t)) / 3);
+  }
+  return signal;
+}
+
+double percentile(const std::vector<double>& sorted, double fraction)
+{
+  return sorted[std::min(sorted.size() - 1, static_cast<size_t>(fraction * sorted.size()))];
+}
+} // namespace
+
+/// Measures the real time factor of the full chain of the plugin, as the host drives it
+/**
+ * Usage: benchmark_chain.exe results.csv [seconds]
+ * For each host sampling rate, block size, preset and model, a fresh chain processes seconds of audio (10 by default)
+ * block by block, after a warmup. The real time factor is the processing time divided by the audio duration, and the
+ * number of instances per core its inverse. The block times are in us, to compare with the deadline of the block.
+ */
+int main(int argc, const char** argv)
+{
+  const double duration = argc > 2 ? std::atof(argv[2]) : 10;
+
+  std::ofstream out(argv[1]);
+  out << "plugin,sampling_rate,block_size,preset,model,real_time_factor,instances_per_core,p50_us,p99_us,max_us,"
+         "deadline_us"
+      << std::endl;
+
+  for(long sampling_rate : SAMPLING_RATES)
+  {
+    const std::vector<float> input = make_signal(sampling_rate, WARMUP + duration);
+    std::vector<float> output(input.size());
+    const auto warmup_size = static_cast<size_t>(sampling_rate * WARMUP);
+
+    for(int block_size : BLOCK_SIZES)
+    {
+      for(const auto& preset : PRESETS)
+      {
+        for(auto model : {PLUGIN::ProcessingChain::Model::Full, PLUGIN::ProcessingChain::Model::Eco})
+        {
+          PLUGIN::ProcessingChain chain;
+          chain.configure(sampling_rate, block_size, PLUGIN::ProcessingChain::Resampling::MinimumPhase, model);
+          chain.setParameters(preset.parameters);
+
+          std::vector<double> block_times;
+          block_times.reserve(input.size() / block_size + 1);
+          double total = 0;
+          for(size_t i = 0; i + block_size <= input.size(); i += block_size)
+          {
+            const auto start = std::chrono::steady_clock::now();
+            chain.process(input.data() + i, output.data() + i, block_size);
+            const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+            if(i >= warmup_size)
+            {
+              block_times.push_back(elapsed.count());
+              total += elapsed.count();
+            }
+          }
+          std::sort(block_times.begin(), block_times.end());
+
+          const double audio = block_times.size() * block_size * 1e6 / sampling_rate;
+          const double real_time_factor = total / audio;
+          const char* model_name = model == PLUGIN::ProcessingChain::Model::Full ? "Full" : "Eco";
+          out << STRINGIFY(PLUGIN) << "," << sampling_rate << "," << block_size << "," << preset.name << ","
+              << model_name << "," << real_time_factor << "," << 1 / real_time_factor << ","
+              << percentile(block_times, .5) << "," << percentile(block_times, .99) << "," << block_times.back()
+              << "," << block_size * 1e6 / sampling_rate << std::endl;
+          std::cout << STRINGIFY(PLUGIN) << " " << sampling_rate << " Hz, " << block_size << " samples, "
+                    << preset.name << ", " << model_name << ": real time factor " << real_time_factor << std::endl;
+        }
+      }
+    }
+  }
+}
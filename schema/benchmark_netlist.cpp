@@ -0,0 +1,101 @@
+#include "NetlistModellerFilter.h"
+
+#include <ATK/Core/InPointerFilter.h>
+#include <ATK/Core/OutPointerFilter.h>
+#include <ATK/Modelling/ModellerFilter.h>
+
+#include <boost/math/constants/constants.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+constexpr gsl::index PROCESSSIZE = 1024 * 1024;
+constexpr gsl::index BLOCKSIZE = 1024;
+constexpr size_t SAMPLING_RATE = 96000;
+
+extern "C"
+{
+  std::unique_ptr<ATK::ModellerFilter<double>> createStaticFilter();
+}
+
+namespace
+{
+/// Processes the input with the filter, returns the time per sample in ns
+double run(ATK::ModellerFilter<double>& filter, const std::vector<double>& input, std::vector<double>& output)
+{
+  ATK::InPointerFilter<double> generator(input.data(), 1, PROCESSSIZE, false);
+  generator.set_output_sampling_rate(SAMPLING_RATE);
+
+  for(gsl::index i = 0; i < filter.get_number_parameters(); ++i)
+  {
+    filter.set_parameter(i, 0.5);
+  }
+  filter.set_input_sampling_rate(SAMPLING_RATE);
+  filter.set_output_sampling_rate(SAMPLING_RATE);
+  filter.set_input_port(filter.find_input_pin("vin"), &generator, 0);
+
+  ATK::OutPointerFilter<double> sink(output.data(), 1, PROCESSSIZE, false);
+  sink.set_input_sampling_rate(SAMPLING_RATE);
+  sink.set_input_port(0, &filter, filter.find_dynamic_pin("vout"));
+
+  const auto start = std::chrono::steady_clock::now();
+  for(gsl::index i = 0; i < PROCESSSIZE; i += BLOCKSIZE)
+  {
+    sink.process(BLOCKSIZE);
+  }
+  const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / PROCESSSIZE;
+}
+} // namespace
+
+/// Compares the runtime netlist engine with the generated stage of the same netlist
+/**
+ * Usage: benchmark.exe netlist.cir report.txt
+ * The executable is linked with the stage generated from netlist.cir. Both filters process the same sweep, and the
+ * report gives the time per sample, the real time factor at 48 kHz with the oversampling factors of the plugin, the
+ * Newton iterations of the runtime engine and the largest difference between the outputs.
+ */
+int main(int argc, const char** argv)
+{
+  std::vector<double> input(PROCESSSIZE);
+  for(gsl::index i = 0; i < PROCESSSIZE; ++i)
+  {
+    auto frequency = (20. + i) / PROCESSSIZE * (20000 - 20);
+    input[i] = std::sin(i * boost::math::constants::pi<double>() * (frequency / SAMPLING_RATE));
+  }
+
+  std::vector<double> generated_output(PROCESSSIZE);
+  std::vector<double> netlist_output(PROCESSSIZE);
+
+  std::unique_ptr<ATK::ModellerFilter<double>> generated = createStaticFilter();
+  const double generated_time = run(*generated, input, generated_output);
+
+  std::unique_ptr<NetlistModellerFilter> netlist = NetlistModellerFilter::load(argv[1]);
+  const double netlist_time = run(*netlist, input, netlist_output);
+
+  double difference = 0;
+  for(gsl::index i = 0; i < PROCESSSIZE; ++i)
+  {
+    difference = std::max(difference, std::abs(generated_output[i] - netlist_output[i]));
+  }
+
+  std::ofstream out(argv[2]);
+  out << argv[1] << ", " << PROCESSSIZE << " samples at " << SAMPLING_RATE << " Hz, blocks of " << BLOCKSIZE << std::endl;
+  out << "generated: " << generated_time << " ns/sample" << std::endl;
+  out << "netlist: " << netlist_time << " ns/sample, "
+      << static_cast<double>(netlist->get_nb_iterations()) / PROCESSSIZE << " iterations/sample" << std::endl;
+  out << "netlist/generated: " << netlist_time / generated_time << std::endl;
+  // Real time factor of a stage alone, the time of one second of audio divided by one second
+  for(int oversampling : {1, 2, 8})
+  {
+    out << "real time factor at 48 kHz x" << oversampling << ": generated "
+        << generated_time * 48000 * oversampling * 1e-9 << ", netlist " << netlist_time * 48000 * oversampling * 1e-9
+        << std::endl;
+  }
+  out << "largest output difference: " << difference << std::endl;
+}
@@ -0,0 +1,193 @@
+#include "PluginStages.h"
+#include "stages/Instrumentation.h"
+
+#include <ATK/Core/InPointerFilter.h>
+#include <ATK/Core/OutPointerFilter.h>
+#include <ATK/Modelling/ModellerFilter.h>
+#include <ATK/Tools/OversamplingFilter.h>
+
+#include <boost/math/constants/constants.hpp>
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAS_CYCLE_COUNTER 1
+#elif defined(_M_X64)
+#include <intrin.h>
+#define HAS_CYCLE_COUNTER 1
+#endif
+
+#ifndef STAGES_COUNT_ITERATIONS
+#error "The stages must be compiled with STAGES_COUNT_ITERATIONS"
+#endif
+
+namespace
+{
+constexpr size_t SAMPLING_RATE = 48000;
+constexpr size_t OVERSAMPLING = 8;
+constexpr gsl::index PROCESSSIZE = SAMPLING_RATE;
+constexpr std::array<gsl::index, 4> BLOCK_SIZES{16, 64, 256, 1024};
+/// distLevel of the plugin, in %
+constexpr std::array<double, 3> DIST_LEVELS{0, 50, 100};
+
+std::uint64_t read_cycles()
+{
+#ifdef HAS_CYCLE_COUNTER
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+/// Input signals at the host sampling rate
+std::vector<double> make_signal(const std::string& name)
+{
+  constexpr double pi = boost::math::constants::pi<double>();
+  std::vector<double> signal(PROCESSSIZE);
+  for(gsl::index i = 0; i < PROCESSSIZE; ++i)
+  {
+    const double t = static_cast<double>(i) / SAMPLING_RATE;
+    if(name == "low-level")
+    {
+      // -40 dB A4
+      signal[i] = .01 * std::sin(2 * pi * 440 * t);
+    }
+    else if(name == "hot-chord")
+    {
+      // Open E power chord at full scale
+      signal[i] = (std::sin(2 * pi * 82.41 * t) + std::sin(2 * pi * 123.47 * t) + std::sin(2 * pi * 164.81 * t)) / 3;
+    }
+    else if(name == "sweep")
+    {
+      // Logarithmic sweep from 20 Hz to 20 kHz
+      const double duration = static_cast<double>(PROCESSSIZE) / SAMPLING_RATE;
+      const double rate = std::log(20000. / 20) / duration;
+      signal[i] = .5 * std::sin(2 * pi * 20 / rate * (std::exp(rate * t) - 1));
+    }
+  }
+  return signal;
+}
+
+std::vector<double> oversample(const std::vector<double>& input)
+{
+  std::vector<double> output(input.size() * OVERSAMPLING);
+  ATK::InPointerFilter<double> generator(input.data(), 1, input.size(), false);
+  generator.set_output_sampling_rate(SAMPLING_RATE);
+  ATK::OversamplingFilter<double, ATK::Oversampling6points5order_8<double>> oversampling;
+  oversampling.set_input_sampling_rate(SAMPLING_RATE);
+  oversampling.set_output_sampling_rate(SAMPLING_RATE * OVERSAMPLING);
+  oversampling.set_input_port(0, &generator, 0);
+  ATK::OutPointerFilter<double> sink(output.data(), 1, output.size(), false);
+  sink.set_input_sampling_rate(SAMPLING_RATE * OVERSAMPLING);
+  sink.set_input_port(0, &oversampling, 0);
+  sink.process(output.size());
+  return output;
+}
+
+struct Measure
+{
+  double ns;
+  double iterations;
+  double cycles;
+};
+
+/// Runs one stage on its input in blocks of block_size, the setup of the stage is not measured
+Measure run(StageFactory factory,
+    gsl::index stage,
+    size_t sampling_rate,
+    double dist_level,
+    gsl::index block_size,
+    const std::vector<double>& input,
+    std::vector<double>& output)
+{
+  const auto size = static_cast<gsl::index>(input.size());
+  ATK::InPointerFilter<double> generator(input.data(), 1, size, false);
+  generator.set_output_sampling_rate(sampling_rate);
+
+  std::unique_ptr<ATK::ModellerFilter<double>> filter = factory();
+  if(stage == 4)
+  {
+    filter->set_parameter(0, dist_level_parameter(dist_level));
+  }
+  filter->set_input_sampling_rate(sampling_rate);
+  filter->set_output_sampling_rate(sampling_rate);
+  filter->set_input_port(filter->find_input_pin("vin"), &generator, 0);
+
+  ATK::OutPointerFilter<double> sink(output.data(), 1, size, false);
+  sink.set_input_sampling_rate(sampling_rate);
+  sink.set_input_port(0, filter.get(), filter->find_dynamic_pin("vout"));
+
+  const std::int64_t start_iterations = Stages::get_nb_iterations(*filter);
+  const auto start = std::chrono::steady_clock::now();
+  const auto start_cycles = read_cycles();
+  for(gsl::index i = 0; i + block_size <= size; i += block_size)
+  {
+    sink.process(block_size);
+  }
+  const auto cycles = read_cycles() - start_cycles;
+  const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  const gsl::index processed = size / block_size * block_size;
+
+  return {elapsed.count() / processed,
+      static_cast<double>(Stages::get_nb_iterations(*filter) - start_iterations) / processed,
+      static_cast<double>(cycles) / processed};
+}
+} // namespace
+
+/// Measures each stage of MT2 and MTB with the sampling rate it has in the plugin
+/**
+ * Usage: benchmark_stages.exe results.csv
+ * Stage 1 runs at the host sampling rate, the others at 8x, and each stage is fed with the output of the previous
+ * ones, so the distortion stages see the levels they see in the plugin. The block sizes are host block sizes.
+ * The cycles are the time stamp counter of x86 processors, which ticks at the nominal frequency, and are left empty
+ * on other processors.
+ */
+int main(int argc, const char** argv)
+{
+  std::ofstream out(argv[1]);
+  out << "plugin,stage,signal,dist_level,block_size,sampling_rate,ns_per_sample,iterations_per_sample,cycles_per_sample"
+      << std::endl;
+
+  for(const auto& plugin : PLUGINS)
+  {
+    for(const std::string signal : {"silence", "low-level", "hot-chord", "sweep"})
+    {
+      for(double dist_level : DIST_LEVELS)
+      {
+        for(gsl::index block_size : BLOCK_SIZES)
+        {
+          std::vector<double> input = make_signal(signal);
+          for(gsl::index stage = 1; stage <= 6; ++stage)
+          {
+            const size_t sampling_rate = stage == 1 ? SAMPLING_RATE : SAMPLING_RATE * OVERSAMPLING;
+            const gsl::index stage_block_size = stage == 1 ? block_size : block_size * OVERSAMPLING;
+            std::vector<double> output(input.size());
+            const Measure measure = run(
+                plugin.stages[stage - 1], stage, sampling_rate, dist_level, stage_block_size, input, output);
+
+            out << plugin.name << "," << stage << "," << signal << "," << dist_level << "," << block_size << ","
+                << sampling_rate << "," << measure.ns << "," << measure.iterations << ",";
+#ifdef HAS_CYCLE_COUNTER
+            out << measure.cycles;
+#endif
+            out << std::endl;
+            std::cout << plugin.name << " stage " << stage << " " << signal << " dist " << dist_level << " block "
+                      << block_size << ": " << measure.ns << " ns/sample, " << measure.iterations
+                      << " iterations/sample" << std::endl;
+
+            input = stage == 1 ? oversample(output) : std::move(output);
+          }
+        }
+      }
+    }
+  }
+}
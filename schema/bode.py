@@ -0,0 +1,33 @@
+import numpy as np
+import sys
+import matplotlib.pyplot as plt
+
+# USAGE:
+# bode.py analysis.csv output.png
+#
+# Plots the frequency response and the harmonic distortion measured by analyze.exe
+
+data = np.genfromtxt(sys.argv[1], delimiter=",", names=True)
+harmonics = [name for name in data.dtype.names if name.startswith("h")]
+
+fig = plt.figure(num=None, figsize=(8, 9), dpi=160, facecolor='w', edgecolor='k')
+
+plt.subplot(3, 1, 1)
+plt.semilogx(data["frequency"], data["magnitude_db"])
+plt.ylabel("dB")
+plt.grid(True, which="both")
+
+plt.subplot(3, 1, 2)
+plt.semilogx(data["frequency"], data["phase_deg"])
+plt.ylabel("degrees")
+plt.grid(True, which="both")
+
+plt.subplot(3, 1, 3)
+for harmonic in harmonics:
+  plt.semilogx(data["frequency"], data[harmonic], label=harmonic.split("_")[0].upper())
+plt.xlabel("Hz")
+plt.ylabel("dB relative to the fundamental")
+plt.legend()
+plt.grid(True, which="both")
+
+plt.savefig(sys.argv[2])
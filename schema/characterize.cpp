@@ -0,0 +1,107 @@
+#include "CharacterizationFile.h"
+#include "ParallelJobs.h"
+#include "PluginStages.h"
+
+#include <ATK/Core/InPointerFilter.h>
+#include <ATK/Core/OutPointerFilter.h>
+#include <ATK/Modelling/ModellerFilter.h>
+
+#include <boost/math/constants/constants.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+// The generated variants all define createStaticFilter, the Makefile renames it after each of them
+extern "C"
+{
+  std::unique_ptr<ATK::ModellerFilter<double>> createStaticFilter_pre_distortion_tone_shaping_ampop();
+  std::unique_ptr<ATK::ModellerFilter<double>> createStaticFilter_pre_distortion_tone_shaping_coil();
+  std::unique_ptr<ATK::ModellerFilter<double>> createStaticFilter_pre_distortion_tone_shaping_transistor();
+}
+
+namespace
+{
+constexpr gsl::index PROCESSSIZE = 4 * 1024 * 1024;
+constexpr size_t SAMPLING_RATE = 96000;
+
+struct Job
+{
+  std::string name;
+  StageFactory factory;
+};
+
+std::vector<Job> make_jobs()
+{
+  std::vector<Job> jobs;
+  for(const auto& plugin : PLUGINS)
+  {
+    for(size_t stage = 0; stage < plugin.stages.size(); ++stage)
+    {
+      jobs.push_back({std::string(plugin.name) + "-" + STAGE_NAMES[stage], plugin.stages[stage]});
+    }
+  }
+  jobs.push_back({"pre-distortion-tone-shaping-ampop", createStaticFilter_pre_distortion_tone_shaping_ampop});
+  jobs.push_back({"pre-distortion-tone-shaping-coil", createStaticFilter_pre_distortion_tone_shaping_coil});
+  jobs.push_back(
+      {"pre-distortion-tone-shaping-transistor", createStaticFilter_pre_distortion_tone_shaping_transistor});
+  return jobs;
+}
+
+/// Same characterization as generate.cpp, the sweep is shared by all the jobs
+std::vector<double> run(StageFactory factory, const std::vector<double>& input)
+{
+  std::vector<double> output(PROCESSSIZE);
+
+  ATK::InPointerFilter<double> generator(input.data(), 1, PROCESSSIZE, false);
+  generator.set_output_sampling_rate(SAMPLING_RATE);
+
+  std::unique_ptr<ATK::ModellerFilter<double>> filter = factory();
+  for(gsl::index i = 0; i < filter->get_number_parameters(); ++i)
+  {
+    filter->set_parameter(i, 0.5);
+  }
+  filter->set_input_sampling_rate(SAMPLING_RATE);
+  filter->set_output_sampling_rate(SAMPLING_RATE);
+  filter->set_input_port(filter->find_input_pin("vin"), &generator, 0);
+
+  ATK::OutPointerFilter<double> sink(output.data(), 1, PROCESSSIZE, false);
+  sink.set_input_sampling_rate(SAMPLING_RATE);
+  sink.set_input_port(0, filter.get(), filter->find_dynamic_pin("vout"));
+
+  for(gsl::index i = 0; i < PROCESSSIZE; i += 1024)
+  {
+    sink.process(1024);
+  }
+  return output;
+}
+} // namespace
+
+/// Characterizes every stage of MT2 and MTB and the pre distortion variants in one pass
+/**
+ * Usage: characterize.exe directory [threads]
+ * Writes directory/MT2-01-high-pass.dat, ..., directory/pre-distortion-tone-shaping-transistor.dat, in the format of
+ * generate.cpp. The jobs are independent, so they are spread over threads (one per core by default), each taking the
+ * next job when it is done with the previous one.
+ */
+int main(int argc, const char** argv)
+{
+  const std::string directory = argv[1];
+
+  std::vector<double> input(PROCESSSIZE);
+  for(size_t i = 0; i < PROCESSSIZE; ++i)
+  {
+    auto frequency = (20. + i) / PROCESSSIZE * (20000 - 20);
+    input[i] = std::sin(i * boost::math::constants::pi<double>() * (frequency / SAMPLING_RATE));
+  }
+
+  const std::vector<Job> jobs = make_jobs();
+  const bool succeeded = run_parallel(jobs.size(), nb_threads(argc, argv, 2), [&](size_t job) {
+    const std::string filename = directory + "/" + jobs[job].name + ".dat";
+    write_characterization(filename, SAMPLING_RATE, input, run(jobs[job].factory, input));
+    return filename;
+  });
+  return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,240 @@
+#include "FFT.h"
+#include "ParallelJobs.h"
+#include "PluginStages.h"
+
+#include <ATK/Core/InPointerFilter.h>
+#include <ATK/Core/OutPointerFilter.h>
+#include <ATK/Modelling/ModellerFilter.h>
+#include <ATK/Tools/OversamplingFilter.h>
+
+#include <boost/math/constants/constants.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+constexpr size_t SAMPLING_RATE = 48000;
+constexpr size_t OVERSAMPLING = 8;
+/// Analysis window, in host samples, the tones are periodic in it so that no window function is needed
+constexpr size_t ANALYSIS_SIZE = 16384;
+constexpr size_t WARMUP_SIZE = 8192;
+constexpr gsl::index BLOCK_SIZE = 1024;
+/// Highest frequency compared, the decimation of the plugin removes the rest
+constexpr double MAX_FREQUENCY = 20000;
+/// Bins of the tones in the analysis window (108 Hz, 1022 Hz and 4005 Hz)
+constexpr std::array<size_t, 3> TONE_BINS{37, 349, 1367};
+/// Peak levels of the host input, in dBFS
+constexpr std::array<double, 4> LEVELS_DB{-30, -18, -6, 0};
+/// distLevel of the plugin, in %, it only changes the input of stage 6
+constexpr std::array<double, 2> DIST_LEVELS{0, 100};
+
+using EcoFactory = std::unique_ptr<ATK::TypedBaseFilter<double>> (*)();
+
+/// Eco models of stages 2 and 6 of a plugin, in the order of PLUGINS
+struct EcoStages
+{
+  const char* name;
+  EcoFactory stage2;
+  EcoFactory stage6;
+};
+
+const std::array<EcoStages, 2> ECO_PLUGINS{{
+    {"MT2", MT2::createStaticFilter_stage2_eco, MT2::createStaticFilter_stage6_eco},
+    {"MTB", MTB::createStaticFilter_stage2_eco, MTB::createStaticFilter_stage6_eco},
+}};
+
+std::vector<double> run(ATK::BaseFilter& filter,
+    gsl::index input_port,
+    gsl::index output_port,
+    size_t input_rate,
+    size_t output_rate,
+    const std::vector<double>& input)
+{
+  const size_t output_size = output_rate > input_rate ? input.size() * (output_rate / input_rate) : input.size();
+  std::vector<double> output(output_size);
+
+  ATK::InPointerFilter<double> generator(input.data(), 1, input.size(), false);
+  generator.set_output_sampling_rate(input_rate);
+  filter.set_input_sampling_rate(input_rate);
+  filter.set_output_sampling_rate(output_rate);
+  filter.set_input_port(input_port, &generator, 0);
+  ATK::OutPointerFilter<double> sink(output.data(), 1, output.size(), false);
+  sink.set_input_sampling_rate(output_rate);
+  sink.set_input_port(0, &filter, output_port);
+
+  for(size_t i = 0; i < output.size(); i += BLOCK_SIZE)
+  {
+    sink.process(std::min<gsl::index>(BLOCK_SIZE, output.size() - i));
+  }
+  return output;
+}
+
+std::vector<double> run_stage(
+    StageFactory factory, gsl::index stage, size_t sampling_rate, double dist_level, const std::vector<double>& input)
+{
+  std::unique_ptr<ATK::ModellerFilter<double>> filter = factory();
+  if(stage == 4)
+  {
+    filter->set_parameter(0, dist_level_parameter(dist_level));
+  }
+  return run(*filter,
+      filter->find_input_pin("vin"),
+      filter->find_dynamic_pin("vout"),
+      sampling_rate,
+      sampling_rate,
+      input);
+}
+
+std::vector<double> run_eco(EcoFactory factory, const std::vector<double>& input)
+{
+  std::unique_ptr<ATK::TypedBaseFilter<double>> filter = factory();
+  return run(*filter, 0, 0, SAMPLING_RATE * OVERSAMPLING, SAMPLING_RATE * OVERSAMPLING, input);
+}
+
+/// Inputs of stages 2 and 6 in the plugin for a host input, at the oversampled rate
+std::array<std::vector<double>, 2> eco_stage_inputs(
+    const PluginStages& plugin, double dist_level, const std::vector<double>& input)
+{
+  std::vector<double> signal = run_stage(plugin.stages[0], 1, SAMPLING_RATE, dist_level, input);
+  ATK::OversamplingFilter<double, ATK::Oversampling6points5order_8<double>> oversampling;
+  signal = run(oversampling, 0, 0, SAMPLING_RATE, SAMPLING_RATE * OVERSAMPLING, signal);
+
+  std::array<std::vector<double>, 2> inputs;
+  inputs[0] = signal;
+  for(gsl::index stage = 2; stage <= 5; ++stage)
+  {
+    signal = run_stage(plugin.stages[stage - 1], stage, SAMPLING_RATE * OVERSAMPLING, dist_level, signal);
+  }
+  inputs[1] = std::move(signal);
+  return inputs;
+}
+
+/// Tone at bin at the host sampling rate, the warmup followed by the analysis window
+std::vector<double> make_tone(size_t bin, double level)
+{
+  const double pi = boost::math::constants::pi<double>();
+  std::vector<double> tone(WARMUP_SIZE + ANALYSIS_SIZE);
+  for(size_t i = 0; i < tone.size(); ++i)
+  {
+    tone[i] = level * std::sin(2 * pi * bin * i / ANALYSIS_SIZE);
+  }
+  return tone;
+}
+
+/// Spectrum of the analysis window of an oversampled signal, the tone stays at the same bin
+std::vector<std::complex<double>> spectrum(const std::vector<double>& signal)
+{
+  std::vector<std::complex<double>> data(signal.end() - ANALYSIS_SIZE * OVERSAMPLING, signal.end());
+  fft(data);
+  return data;
+}
+
+struct Point
+{
+  std::string plugin;
+  gsl::index stage;
+  double dist_level;
+  double level_db;
+  double frequency;
+  /// Gain and phase of the eco stage relative to the full stage on the tone
+  double fundamental_db;
+  double phase_deg;
+  /// Energy of the difference between both outputs relative to the output of the full stage, up to MAX_FREQUENCY
+  double difference_db;
+};
+
+/// Compares the outputs of the full and of the eco stage over the analysis window
+void compare(const std::vector<double>& full, const std::vector<double>& eco, size_t bin, Point& point)
+{
+  const double pi = boost::math::constants::pi<double>();
+  const auto reference = spectrum(full);
+  const auto linearized = spectrum(eco);
+  const auto last_bin = static_cast<size_t>(MAX_FREQUENCY * ANALYSIS_SIZE / SAMPLING_RATE);
+
+  // DC is left out, both stages may settle on slightly different operating points
+  double energy = 0;
+  double error = 0;
+  for(size_t i = 1; i <= last_bin; ++i)
+  {
+    energy += std::norm(reference[i]);
+    error += std::norm(linearized[i] - reference[i]);
+  }
+  const auto ratio = linearized[bin] / reference[bin];
+  point.frequency = static_cast<double>(bin) * SAMPLING_RATE / ANALYSIS_SIZE;
+  point.fundamental_db = 20 * std::log10(std::abs(ratio));
+  point.phase_deg = std::arg(ratio) * 180 / pi;
+  point.difference_db = 10 * std::log10(error / energy);
+}
+} // namespace
+
+/// Compares the eco stages with the full stages they replace, at the input levels they get in the plugin
+/**
+ * Usage: eco_accuracy.exe results.csv [threads]
+ * The host input is a tone at 108 Hz, 1022 Hz or 4005 Hz, from -30 dBFS to 0 dBFS. It goes through the stages of
+ * the plugin up to stages 2 and 6, with distLevel at 0% and 100%, and the input of each stage is rendered both by the
+ * nonlinear ModellerFilter stage and by its eco model. For each case, the CSV gets the gain and phase of the eco stage
+ * relative to the full stage on the tone, and the energy of the difference between both outputs up to 20 kHz,
+ * harmonics included, relative to the output of the full stage.
+ * The jobs run in parallel, one thread per core by default.
+ */
+int main(int argc, const char** argv)
+{
+  const size_t nb_cases = DIST_LEVELS.size() * LEVELS_DB.size() * TONE_BINS.size();
+  std::vector<std::vector<Point>> results(PLUGINS.size() * nb_cases);
+
+  const bool succeeded = run_parallel(results.size(), nb_threads(argc, argv, 2), [&](size_t job) {
+    const size_t plugin = job / nb_cases;
+    const size_t dist = job / (LEVELS_DB.size() * TONE_BINS.size()) % DIST_LEVELS.size();
+    const size_t level = job / TONE_BINS.size() % LEVELS_DB.size();
+    const size_t bin = TONE_BINS[job % TONE_BINS.size()];
+
+    const std::vector<double> tone = make_tone(bin, std::pow(10, LEVELS_DB[level] / 20));
+    const auto inputs = eco_stage_inputs(PLUGINS[plugin], DIST_LEVELS[dist], tone);
+    const std::array<EcoFactory, 2> eco_stages{ECO_PLUGINS[plugin].stage2, ECO_PLUGINS[plugin].stage6};
+    const std::array<gsl::index, 2> stages{2, 6};
+
+    std::ostringstream log;
+    for(size_t i = 0; i < stages.size(); ++i)
+    {
+      // The input of stage 2 doesn't depend on distLevel, it is only compared once
+      if(stages[i] == 2 && dist != 0)
+      {
+        continue;
+      }
+      const std::vector<double> full = run_stage(
+          PLUGINS[plugin].stages[stages[i] - 1], stages[i], SAMPLING_RATE * OVERSAMPLING, DIST_LEVELS[dist], inputs[i]);
+      const std::vector<double> eco = run_eco(eco_stages[i], inputs[i]);
+
+      Point point{ECO_PLUGINS[plugin].name, stages[i], DIST_LEVELS[dist], LEVELS_DB[level]};
+      compare(full, eco, bin, point);
+      results[job].push_back(point);
+      log << (results[job].size() > 1 ? "\n" : "") << point.plugin << " stage" << point.stage << " dist " << point.dist_level << "% "
+          << point.level_db << " dBFS " << point.frequency << " Hz: " << point.fundamental_db << " dB, "
+          << point.difference_db << " dB of difference";
+    }
+    return log.str();
+  });
+
+  std::ofstream out(argv[1]);
+  out << "plugin,stage,dist_level,level_db,frequency,fundamental_db,phase_deg,difference_db" << std::endl;
+  for(const auto& points : results)
+  {
+    for(const auto& point : points)
+    {
+      out << point.plugin << "," << point.stage << "," << point.dist_level << "," << point.level_db << ","
+          << point.frequency << "," << point.fundamental_db << "," << point.phase_deg << "," << point.difference_db
+          << std::endl;
+    }
+  }
+  return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
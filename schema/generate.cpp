@@ -1,3 +1,4 @@
+#include "CharacterizationFile.h"
 
 #include <ATK/Core/InPointerFilter.h>
 #include <ATK/Core/OutPointerFilter.h>
@@ -5,7 +6,6 @@
 
 #include <boost/math/constants/constants.hpp>
 
-#include <fstream>
 #include <memory>
 #include <vector>
 
@@ -48,9 +48,5 @@ int main(int argc, const char** argv)
     sink.process(1024);
   }
 
-  std::ofstream out(argv[1]);
-  for(size_t i = 0; i < PROCESSSIZE; ++i)
-  {
-    out << input[i] << "\t" << output[i] << std::endl;
-  }
+  write_characterization(argv[1], SAMPLING_RATE, input, output);
 }
@@ -0,0 +1,88 @@
+#!/usr/bin/python3
+
+# USAGE:
+# kernelize.py stage.cpp [stage.cpp ...]
+#
+# Rewrites the process_impl of stages generated by ATKModellingGenerator into block kernels, in place.
+#
+# The generated process_impl reads and writes the mutable input_state and dynamic_state members through this
+# for every sample and every Newton iteration, and loops over nb_input_ports and nb_output_ports. The kernel
+# copies both states to locals at the beginning of the block and back at its end, passes them by reference to
+# solve() and iterate(), and unrolls the port loops with the pin counts of the netlist, so that the compiler can
+# keep the Newton state in registers for the whole block. The results are the same bit for bit.
+#
+# Files that were already rewritten are left untouched, so the script can be run on all the stages.
+
+import re
+import sys
+
+def state_size(source, name):
+  match = re.search(r"mutable Eigen::Matrix<DataType, (\d+), 1> %s\{" % name, source)
+  if match is None:
+    raise RuntimeError("No %s in the generated file" % name)
+  return int(match.group(1))
+
+def local_states(text):
+  "Replaces the state members by the locals of the kernel"
+  return re.sub(r"\binput_state\b", "input", re.sub(r"\bdynamic_state\b", "dynamic", text))
+
+def kernel(nb_inputs, nb_dynamic, updates):
+  lines = ["  void process_impl(gsl::index size) const override",
+           "  {",
+           "    // The states are kept in locals for the whole block, so that they can stay in registers"]
+  for j in range(nb_inputs):
+    lines.append("    const DataType* ATK_RESTRICT input%d = converted_inputs[%d];" % (j, j))
+  for j in range(nb_dynamic):
+    lines.append("    DataType* ATK_RESTRICT output%d = outputs[%d];" % (j, j))
+  lines += ["    Eigen::Matrix<DataType, %d, 1> input = input_state;" % nb_inputs,
+            "    Eigen::Matrix<DataType, %d, 1> dynamic = dynamic_state;" % nb_dynamic,
+            "",
+            "    for(gsl::index i = 0; i < size; ++i)",
+            "    {"]
+  for j in range(nb_inputs):
+    lines.append("      input[%d] = input%d[i];" % (j, j))
+  lines += ["",
+            "      solve<false>(input, dynamic);",
+            "",
+            "      // Update state"]
+  lines += [local_states(update) for update in updates]
+  for j in range(nb_dynamic):
+    lines.append("      output%d[i] = dynamic[%d];" % (j, j))
+  lines += ["    }",
+            "",
+            "    input_state = input;",
+            "    dynamic_state = dynamic;",
+            "  }",
+            ""]
+  return "\n".join(lines)
+
+def kernelize(source):
+  if "solve<false>(input, dynamic);" in source:
+    return source
+  nb_inputs = state_size(source, "input_state")
+  nb_dynamic = state_size(source, "dynamic_state")
+  arguments = "const Eigen::Matrix<DataType, %d, 1>& input, Eigen::Matrix<DataType, %d, 1>& dynamic" % (nb_inputs, nb_dynamic)
+
+  start = source.index("  void process_impl(gsl::index size) const override\n")
+  end = source.index("\n  }\n", start) + len("\n  }\n")
+  block = source[start:end]
+  updates = block[block.index("// Update state\n") + len("// Update state\n"):block.index("      for(gsl::index j = 0; j < nb_output_ports; ++j)")]
+  source = source[:start] + kernel(nb_inputs, nb_dynamic, updates.rstrip("\n").split("\n")) + source[end:]
+
+  # solve() and iterate() work on the states they are given, init() gives them the members
+  source = source.replace("  void solve() const\n", "  void solve(%s) const\n" % arguments)
+  source = source.replace("!iterate<steady_state>()", "!iterate<steady_state>(input, dynamic)")
+  source = source.replace("solve<true>();", "solve<true>(input_state, dynamic_state);")
+  start = source.index("  bool iterate() const\n")
+  end = source.index("\n  }\n};", start)
+  source = source[:start] + local_states(source[start:end]).replace(
+      "  bool iterate() const\n", "  bool iterate(%s) const\n" % arguments) + source[end:]
+  return source
+
+if __name__ == "__main__":
+  for filename in sys.argv[1:]:
+    source = open(filename).read()
+    kernelized = kernelize(source)
+    if kernelized != source:
+      with open(filename, "w") as output:
+        output.write(kernelized)
@@ -0,0 +1,454 @@
+#!/usr/bin/python3
+
+# USAGE:
+# linearize.py netlist.cir namespace stage output.cpp
+#
+# Replaces the transistors of the gyrators of a netlist by their small signal model at the operating
+# point, and generates from the resulting linear netlist:
+# - netlist-eco.cir, the linear netlist,
+# - output.cpp, a LinearStateSpaceFilter with the continuous state space of the netlist, that the
+#   plugin discretizes at its sampling rate,
+# - netlist-eco.txt, the small signal response of the original netlist at its operating point, the
+#   spectral difference of the ideal coil substitution with it, and the input level up to which the
+#   linearization holds.
+# The eco stage is the small signal model itself, its difference with the nonlinear stage at the levels
+# it gets in the plugin is measured by eco_accuracy.cpp (make eco-accuracy).
+
+import math
+import re
+import sys
+
+import numpy as np
+
+SUFFIXES = {"t": 1e12, "g": 1e9, "meg": 1e6, "k": 1e3, "m": 1e-3, "u": 1e-6, "n": 1e-9, "p": 1e-12, "f": 1e-15}
+
+def parse_value(text):
+  match = re.match(r"([-+]?[0-9]*\.?[0-9]+(?:e[-+]?[0-9]+)?)(meg|[tgkmunpf])?", text.lower())
+  if match is None:
+    raise ValueError("Can't parse value " + text)
+  return float(match.group(1)) * SUFFIXES.get(match.group(2), 1)
+
+def parse_netlist(filename):
+  "Returns the elements and the transistor models of a netlist"
+  elements = []
+  models = {}
+  for line in open(filename):
+    tokens = line.split()
+    if not tokens or tokens[0].startswith("*"):
+      continue
+    if tokens[0].lower() == ".model":
+      parameters = " ".join(tokens[2:])
+      parameters = parameters[parameters.index("(") + 1:parameters.rindex(")")]
+      models[tokens[1]] = dict((key.lower(), parse_value(value)) for key, value in re.findall(r"(\w+)=(\S+)", parameters))
+      continue
+    name = tokens[0]
+    kind = name[0].upper()
+    nodes = [node.lower() for node in tokens[1:]]
+    if kind in "RCL":
+      elements.append({"kind": kind, "name": name, "nodes": nodes[:2], "value": parse_value(tokens[3])})
+    elif kind == "P":
+      # Potentiometer: first end, second end, wiper, value, considered at its middle position
+      elements.append({"kind": kind, "name": name, "nodes": nodes[:3], "value": parse_value(tokens[4]), "position": .5})
+    elif kind == "D":
+      # Anode, cathode
+      elements.append({"kind": kind, "name": name, "nodes": nodes[:2], "model": tokens[3]})
+    elif kind == "V":
+      element = {"kind": kind, "name": name, "nodes": nodes[:2], "dc": 0, "ac": 0}
+      for i in range(3, len(tokens) - 1, 2):
+        element[tokens[i].lower()] = parse_value(tokens[i + 1])
+      elements.append(element)
+    elif kind == "G":
+      # Voltage controlled current source: out+, out-, control+, control-, transconductance
+      elements.append({"kind": kind, "name": name, "nodes": nodes[:2], "controls": nodes[2:4], "value": parse_value(tokens[5])})
+    elif kind == "Z":
+      # Ideal opamp: V-, V+, Vout
+      elements.append({"kind": kind, "name": name, "nodes": nodes[:3]})
+    elif kind == "Q":
+      # Collector, base, emitter
+      elements.append({"kind": kind, "name": name, "nodes": nodes[:3], "model": tokens[4]})
+    else:
+      raise ValueError("Unsupported element " + name)
+    elements[-1]["line"] = line.rstrip("\n")
+  return elements, models
+
+def write_netlist(filename, elements, comments):
+  with open(filename, "w") as output:
+    output.write("*\n")
+    for comment in comments:
+      output.write("* " + comment + "\n")
+    for element in elements:
+      if element["kind"] == "V":
+        output.write("%s\t%s\t%s\tAC\t%g\n" % (element["name"], element["nodes"][0], element["nodes"][1], element["ac"]))
+      elif element["kind"] == "G":
+        output.write("%s\t%s\t%s\t%s\t%s\t%.9g\n" % (element["name"], *element["nodes"], *element["controls"], element["value"]))
+      elif element["kind"] == "Z":
+        output.write("%s\t%s\t%s\t%s\n" % (element["name"], *element["nodes"]))
+      else:
+        output.write("%s\t%s\t%s\t%.9g\n" % (element["name"], element["nodes"][0], element["nodes"][1], element["value"]))
+
+def other_node(element, node):
+  return element["nodes"][1] if element["nodes"][0] == node else element["nodes"][0]
+
+def find_gyrators(elements):
+  """Returns the emitter follower gyrators of a netlist
+
+  A gyrator is a capacitor from the port to the base, a resistor from the base to the ground, a
+  resistor from the port to the emitter and a bias resistor from the emitter to a supply.
+  """
+  supplies = set(e["nodes"][0] for e in elements if e["kind"] == "V" and e["ac"] == 0)
+  connected = lambda node, kind: [e for e in elements if e["kind"] == kind and node in e["nodes"]]
+  gyrators = []
+  for transistor in [e for e in elements if e["kind"] == "Q"]:
+    collector, base, emitter = transistor["nodes"]
+    base_resistor = [r for r in connected(base, "R") if other_node(r, base) == "0"]
+    bias_resistor = [r for r in connected(emitter, "R") if other_node(r, emitter) in supplies]
+    emitter_resistor = [r for r in connected(emitter, "R") if other_node(r, emitter) not in supplies]
+    if len(base_resistor) != 1 or len(bias_resistor) != 1 or len(emitter_resistor) != 1:
+      raise ValueError("%s is not a gyrator" % transistor["name"])
+    port = other_node(emitter_resistor[0], emitter)
+    capacitor = [c for c in connected(base, "C") if other_node(c, base) == port]
+    if len(capacitor) != 1:
+      raise ValueError("%s is not a gyrator" % transistor["name"])
+    gyrators.append({"transistor": transistor, "capacitor": capacitor[0], "base_resistor": base_resistor[0],
+        "emitter_resistor": emitter_resistor[0], "bias_resistor": bias_resistor[0]})
+  return gyrators
+
+class MNA:
+  "Modified nodal analysis of a netlist, unknowns are the node voltages and then the branch currents"
+
+  def __init__(self, elements, branches):
+    self.nodes = sorted(set(n for e in elements for n in e["nodes"] + e.get("controls", []) if n != "0"))
+    self.branches = branches
+    self.size = len(self.nodes) + len(branches)
+
+  def node(self, name):
+    return None if name == "0" else self.nodes.index(name)
+
+  def branch(self, name):
+    return len(self.nodes) + self.branches.index(name)
+
+  def conductance(self, Y, nodes, value):
+    a, b = (self.node(n) for n in nodes)
+    for i, j, sign in ((a, a, 1), (b, b, 1), (a, b, -1), (b, a, -1)):
+      if i is not None and j is not None:
+        Y[i, j] += sign * value
+
+  def transconductance(self, Y, nodes, controls, value):
+    "Current value * (V(c+) - V(c-)) from the first node to the second one through the element"
+    for node, sign in zip(nodes, (1, -1)):
+      for control, polarity in zip(controls, (1, -1)):
+        if node != "0" and control != "0":
+          Y[self.node(node), self.node(control)] += sign * polarity * value
+
+  def voltage(self, Y, rhs, nodes, name, value, impedance=0):
+    "Branch current from the first node to the second one through the element, V(+) - V(-) - Z I = value"
+    a, b = (self.node(n) for n in nodes)
+    k = self.branch(name)
+    if a is not None:
+      Y[a, k] += 1
+      Y[k, a] += 1
+    if b is not None:
+      Y[b, k] -= 1
+      Y[k, b] -= 1
+    Y[k, k] -= impedance
+    rhs[k] += value
+
+  def current(self, rhs, nodes, value):
+    "Current from the first node to the second one through the element"
+    a, b = (self.node(n) for n in nodes)
+    if a is not None:
+      rhs[a] -= value
+    if b is not None:
+      rhs[b] += value
+
+  def opamp(self, Y, element):
+    minus, plus, output = (self.node(n) for n in element["nodes"])
+    k = self.branch(element["name"])
+    Y[output, k] -= 1
+    if plus is not None:
+      Y[k, plus] += 1
+    if minus is not None:
+      Y[k, minus] -= 1
+
+  def resistive(self, Y, elements):
+    "Stamps the resistors, the controlled sources and the opamps"
+    for e in elements:
+      if e["kind"] == "R":
+        self.conductance(Y, e["nodes"], 1 / e["value"])
+      elif e["kind"] == "P":
+        self.conductance(Y, (e["nodes"][0], e["nodes"][2]), 1 / (e["value"] * e["position"]))
+        self.conductance(Y, (e["nodes"][2], e["nodes"][1]), 1 / (e["value"] * (1 - e["position"])))
+      elif e["kind"] == "G":
+        self.transconductance(Y, e["nodes"], e["controls"], e["value"])
+      elif e["kind"] == "Z":
+        self.opamp(Y, e)
+
+def transistor_currents(model, vbe, vbc):
+  "Ebers-Moll currents entering the collector and the base"
+  vt = model.get("vt", 26e-3) * model.get("ne", 1)
+  ebe = math.exp(min(vbe, 1) / vt) - 1
+  ebc = math.exp(min(vbc, 1) / vt) - 1
+  ic = model["is"] * (ebe - ebc) - model["is"] / model["br"] * ebc
+  ib = model["is"] / model["bf"] * ebe + model["is"] / model["br"] * ebc
+  return ic, ib
+
+def diode_current(model, v):
+  "Shockley current from the anode to the cathode"
+  return model["is"] * (math.exp(min(v, 1) / (model.get("vt", 26e-3) * model.get("n", 1))) - 1)
+
+def operating_point(elements, models):
+  "Newton solve of the DC operating point, capacitors open, coils shorted and supplies ramped up"
+  branches = [e["name"] for e in elements if e["kind"] in "VZL"]
+  mna = MNA(elements, branches)
+  x = np.zeros(mna.size)
+
+  def residual(x, scale):
+    Y = np.zeros((mna.size, mna.size))
+    rhs = np.zeros(mna.size)
+    mna.resistive(Y, elements)
+    for e in elements:
+      if e["kind"] == "V":
+        mna.voltage(Y, rhs, e["nodes"], e["name"], e["dc"] * scale)
+      elif e["kind"] == "L":
+        mna.voltage(Y, rhs, e["nodes"], e["name"], 0)
+    f = Y @ x - rhs
+    voltage = lambda n: 0 if n == "0" else x[mna.node(n)]
+    for e in elements:
+      if e["kind"] == "Q":
+        c, b, emitter = e["nodes"]
+        ic, ib = transistor_currents(models[e["model"]], voltage(b) - voltage(emitter), voltage(b) - voltage(c))
+        for node, value in ((c, ic), (b, ib), (emitter, -ic - ib)):
+          if node != "0":
+            f[mna.node(node)] += value
+      elif e["kind"] == "D":
+        current = diode_current(models[e["model"]], voltage(e["nodes"][0]) - voltage(e["nodes"][1]))
+        for node, value in zip(e["nodes"], (current, -current)):
+          if node != "0":
+            f[mna.node(node)] += value
+    return f
+
+  for scale in np.linspace(.1, 1, 10):
+    for iteration in range(200):
+      f = residual(x, scale)
+      jacobian = np.zeros((mna.size, mna.size))
+      for i in range(mna.size):
+        dx = np.zeros(mna.size)
+        dx[i] = 1e-7
+        jacobian[:, i] = (residual(x + dx, scale) - f) / 1e-7
+      delta = np.linalg.solve(jacobian, f)
+      x -= np.clip(delta, -.1, .1)
+      if np.max(np.abs(delta)) < 1e-12:
+        break
+  return lambda n: 0 if n == "0" else x[mna.node(n)]
+
+def linearize_gyrators(elements, models):
+  """Replaces each gyrator transistor by its small signal model at the operating point
+
+  The Ebers-Moll collector and base currents are linearized with respect to Vbe and Vbc, which gives
+  four voltage controlled current sources towards the emitter. The supplies stay as AC grounds.
+  Returns the linear netlist, a description of the linearizations, and for each transistor its emitter
+  bias current and its controlled sources.
+  """
+  voltage = operating_point(elements, models)
+  linear = list(elements)
+  comments = []
+  biases = []
+  for gyrator in find_gyrators(elements):
+    transistor = gyrator["transistor"]
+    sources, comment, bias = linearize_transistor(transistor, models[transistor["model"]], voltage)
+    linear.remove(transistor)
+    linear += sources
+    comments.append(comment)
+    biases.append((transistor["name"], bias, sources))
+  return linear, comments, biases
+
+def linearize_transistor(transistor, model, voltage):
+  "Returns the controlled sources of a transistor at the given node voltages, a description and its emitter current"
+  collector, base, emitter = transistor["nodes"]
+  vbe = voltage(base) - voltage(emitter)
+  vbc = voltage(base) - voltage(collector)
+  ic, ib = transistor_currents(model, vbe, vbc)
+  icbe, ibbe = transistor_currents(model, vbe + 1e-7, vbc)
+  icbc, ibbc = transistor_currents(model, vbe, vbc + 1e-7)
+  suffix = transistor["name"][1:]
+  sources = []
+  for name, terminal, controls, value in (("Gcbe", collector, (base, emitter), (icbe - ic) / 1e-7),
+      ("Gcbc", collector, (base, collector), (icbc - ic) / 1e-7),
+      ("Gbbe", base, (base, emitter), (ibbe - ib) / 1e-7),
+      ("Gbbc", base, (base, collector), (ibbc - ib) / 1e-7)):
+    sources.append({"kind": "G", "name": name + suffix, "nodes": [terminal, emitter], "controls": list(controls), "value": value})
+  comment = "%s linearized at Ic = %.3f mA (gm = %.2f mS, rpi = %.0f Ohm)" % (transistor["name"], ic * 1e3, (icbe - ic) / 1e-10, 1e-7 / (ibbe - ib))
+  return sources, comment, ic + ib
+
+def small_signal(elements, models):
+  "Replaces all transistors and diodes by their small signal model at the operating point"
+  voltage = operating_point(elements, models)
+  linear = []
+  for e in elements:
+    if e["kind"] == "Q":
+      linear += linearize_transistor(e, models[e["model"]], voltage)[0]
+    elif e["kind"] == "D":
+      v = voltage(e["nodes"][0]) - voltage(e["nodes"][1])
+      conductance = (diode_current(models[e["model"]], v + 1e-7) - diode_current(models[e["model"]], v)) / 1e-7
+      linear.append({"kind": "R", "name": "R" + e["name"], "nodes": e["nodes"], "value": 1 / conductance})
+    else:
+      linear.append(e)
+  return linear
+
+def coil_gyrators(elements):
+  """Replaces each gyrator by an ideal coil, as in pre-distortion-tone-shaping-coil.cir
+
+  With an ideal follower, the port sees the emitter resistor in series with a coil of value
+  Re * Rb * C, in parallel with the capacitor and the base resistor.
+  """
+  linear = list(elements)
+  comments = []
+  for gyrator in find_gyrators(elements):
+    transistor = gyrator["transistor"]
+    inductance = gyrator["emitter_resistor"]["value"] * gyrator["base_resistor"]["value"] * gyrator["capacitor"]["value"]
+    linear.remove(transistor)
+    linear.remove(gyrator["bias_resistor"])
+    linear.append({"kind": "L", "name": "L" + transistor["name"][1:], "nodes": [transistor["nodes"][2], "0"], "value": inductance})
+    comments.append("Ideal coils: %s replaced by a %.4g H coil" % (transistor["name"], inductance))
+  return linear, comments
+
+def ac_solve(elements, frequency):
+  "Node voltages of a linear netlist for the AC input"
+  branches = [e["name"] for e in elements if e["kind"] in "VZL"]
+  mna = MNA(elements, branches)
+  omega = 2 * math.pi * frequency
+  Y = np.zeros((mna.size, mna.size), dtype=complex)
+  rhs = np.zeros(mna.size, dtype=complex)
+  mna.resistive(Y, elements)
+  for e in elements:
+    if e["kind"] == "C":
+      mna.conductance(Y, e["nodes"], 1j * omega * e["value"])
+    elif e["kind"] == "L":
+      mna.voltage(Y, rhs, e["nodes"], e["name"], 0, 1j * omega * e["value"])
+    elif e["kind"] == "V":
+      mna.voltage(Y, rhs, e["nodes"], e["name"], e["ac"])
+  x = np.linalg.solve(Y, rhs)
+  return lambda n: 0 if n == "0" else x[mna.node(n)]
+
+def ac_response(elements, frequencies):
+  return np.array([ac_solve(elements, frequency)("vout") for frequency in frequencies])
+
+def headroom(linear, biases, frequencies):
+  """Input amplitude at which the AC emitter current of a linearized transistor reaches its bias current
+
+  Above it, the transistor is cut off on a half wave, and the eco stage doesn't follow the original one.
+  """
+  results = []
+  for name, bias, sources in biases:
+    currents = []
+    for frequency in frequencies:
+      voltage = ac_solve(linear, frequency)
+      currents.append(abs(sum(s["value"] * (voltage(s["controls"][0]) - voltage(s["controls"][1])) for s in sources)))
+    worst = np.argmax(currents)
+    results.append("%s: %.3f V at %.0f Hz" % (name, abs(bias) / currents[worst], frequencies[worst]))
+  return results
+
+def state_space(elements):
+  """Continuous state space of a linear netlist, the states are the capacitor voltages and the coil currents
+
+  Each capacitor is replaced by a voltage source and each coil by a current source, and the resulting
+  resistive network gives the capacitor currents, the coil voltages and the output for each state and
+  for the input.
+  """
+  capacitors = [e for e in elements if e["kind"] == "C"]
+  coils = [e for e in elements if e["kind"] == "L"]
+  branches = [e["name"] for e in elements if e["kind"] in "VZC"]
+  mna = MNA(elements, branches)
+  nb_states = len(capacitors) + len(coils)
+
+  derivatives = np.zeros((nb_states, nb_states + 1))
+  outputs = np.zeros(nb_states + 1)
+  for column in range(nb_states + 1):
+    Y = np.zeros((mna.size, mna.size))
+    rhs = np.zeros(mna.size)
+    mna.resistive(Y, elements)
+    for e in elements:
+      if e["kind"] == "V":
+        mna.voltage(Y, rhs, e["nodes"], e["name"], 1 if e["ac"] != 0 and column == nb_states else 0)
+    for i, capacitor in enumerate(capacitors):
+      mna.voltage(Y, rhs, capacitor["nodes"], capacitor["name"], 1 if column == i else 0)
+    for i, coil in enumerate(coils):
+      mna.current(rhs, coil["nodes"], 1 if column == len(capacitors) + i else 0)
+    x = np.linalg.solve(Y, rhs)
+    voltage = lambda n: 0 if n == "0" else x[mna.node(n)]
+    for i, capacitor in enumerate(capacitors):
+      derivatives[i, column] = x[mna.branch(capacitor["name"])] / capacitor["value"]
+    for i, coil in enumerate(coils):
+      derivatives[len(capacitors) + i, column] = (voltage(coil["nodes"][0]) - voltage(coil["nodes"][1])) / coil["value"]
+    outputs[column] = voltage("vout")
+  names = [e["name"] for e in capacitors + coils]
+  return names, derivatives[:, :nb_states], derivatives[:, nb_states], outputs[:nb_states], outputs[nb_states]
+
+def state_space_response(A, B, C, D, frequencies):
+  return np.array([C @ np.linalg.solve(2j * math.pi * f * np.eye(len(B)) - A, B) + D for f in frequencies])
+
+def write_report(filename, source, frequencies, original, variants, comments):
+  with open(filename, "w") as output:
+    output.write("Spectral difference between %s and its ideal coil substitution\n" % source)
+    output.write("The reference is the small signal response of %s at its operating point\n" % source)
+    output.write("The eco stage is that small signal model, make eco-accuracy compares it with the nonlinear stage\n")
+    for comment in comments:
+      output.write(comment + "\n")
+    output.write("\n")
+    differences = []
+    for label, response in variants:
+      difference = 20 * np.log10(np.abs(response / original))
+      phase = np.degrees(np.angle(response / original))
+      worst = np.argmax(np.abs(difference))
+      output.write("%s: maximum difference %.3f dB at %.0f Hz, maximum phase difference %.2f degrees\n" % (label, difference[worst], frequencies[worst], np.max(np.abs(phase))))
+      differences.append(difference)
+    output.write("\nHz\treference (dB)\t" + "\t".join("%s (dB)" % label for label, response in variants) + "\n")
+    for i in range(0, len(frequencies), 10):
+      output.write("%.0f\t%.3f\t" % (frequencies[i], 20 * np.log10(np.abs(original[i]))) + "\t".join("%.3f" % difference[i] for difference in differences) + "\n")
+
+def format_row(values):
+  return "{" + ", ".join("%.17g" % (value + 0.) for value in values) + "}"
+
+def write_filter(filename, source, namespace, stage, comments, names, A, B, C, D):
+  with open(filename, "w") as output:
+    output.write("""/**
+ * \\file %s
+ * Generated by schema/linearize.py from %s, do not edit
+ */
+
+#include "LinearStateSpaceFilter.h"
+#include "static_elements.h"
+
+namespace %s
+{
+std::unique_ptr<ATK::TypedBaseFilter<double>> createStaticFilter_%s_eco()
+{
+""" % (filename.split("/")[-1], source, namespace, stage))
+    for comment in comments:
+      output.write("  // %s\n" % comment)
+    output.write("  // States: %s\n" % ", ".join(names))
+    output.write("  using Filter = LinearStateSpaceFilter<%d>;\n" % len(B))
+    output.write("  return std::make_unique<Filter>(Filter::Matrix{{%s}},\n" % ",\n      ".join(format_row(row) for row in A))
+    output.write("      Filter::Vector{%s},\n" % format_row(B))
+    output.write("      Filter::Vector{%s},\n" % format_row(C))
+    output.write("      %.17g);\n" % D)
+    output.write("}\n} // namespace %s\n" % namespace)
+
+if __name__ == "__main__":
+  source, namespace, stage, cpp = sys.argv[1:5]
+  base = source[:-len(".cir")]
+  elements, models = parse_netlist(source)
+  linear, comments, biases = linearize_gyrators(elements, models)
+  write_netlist(base + "-eco.cir", linear, ["Linear equivalent of " + source] + comments)
+
+  names, A, B, C, D = state_space(linear)
+  frequencies = np.logspace(math.log10(20), math.log10(20000), 301)
+  response = state_space_response(A, B, C, D, frequencies)
+  original = ac_response(linear, frequencies)
+  assert np.max(np.abs(response / original - 1)) < 1e-6, "State space doesn't match the netlist"
+
+  coils, coil_comments = coil_gyrators(elements)
+  write_report(base + "-eco.txt", source, frequencies, original,
+      [("ideal coils", ac_response(coils, frequencies))],
+      comments + coil_comments + ["Input amplitude where the emitter current cuts off, " + result for result in headroom(linear, biases, frequencies)])
+  write_filter(cpp, source, namespace, stage, comments, names, A, B, C, D)
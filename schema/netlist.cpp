@@ -0,0 +1,51 @@
+#include "NetlistModellerFilter.h"
+#include "CharacterizationFile.h"
+
+#include <ATK/Core/InPointerFilter.h>
+#include <ATK/Core/OutPointerFilter.h>
+
+#include <boost/math/constants/constants.hpp>
+
+#include <memory>
+#include <vector>
+
+constexpr gsl::index PROCESSSIZE = 4 * 1024 * 1024;
+constexpr size_t SAMPLING_RATE = 96000;
+
+/// Same sweep as generate.cpp, with the netlist loaded at runtime instead of generated and compiled
+/**
+ * Usage: netlist.exe netlist.cir output.dat
+ */
+int main(int argc, const char** argv)
+{
+  std::vector<double> input(PROCESSSIZE);
+  std::vector<double> output(PROCESSSIZE);
+  for(size_t i = 0; i < PROCESSSIZE; ++i)
+  {
+    auto frequency = (20. + i) / PROCESSSIZE * (20000 - 20);
+    input[i] = std::sin(i * boost::math::constants::pi<double>() * (frequency / SAMPLING_RATE));
+  }
+
+  ATK::InPointerFilter<double> generator(input.data(), 1, PROCESSSIZE, false);
+  generator.set_output_sampling_rate(SAMPLING_RATE);
+
+  std::unique_ptr<NetlistModellerFilter> filter = NetlistModellerFilter::load(argv[1]);
+  for(gsl::index i = 0; i < filter->get_number_parameters(); ++i)
+  {
+    filter->set_parameter(i, 0.5);
+  }
+  filter->set_input_sampling_rate(SAMPLING_RATE);
+  filter->set_output_sampling_rate(SAMPLING_RATE);
+  filter->set_input_port(filter->find_input_pin("vin"), &generator, 0);
+
+  ATK::OutPointerFilter<double> sink(output.data(), 1, PROCESSSIZE, false);
+  sink.set_input_sampling_rate(SAMPLING_RATE);
+  sink.set_input_port(0, filter.get(), filter->find_dynamic_pin("vout"));
+
+  for(gsl::index i = 0; i < PROCESSSIZE; i += 1024)
+  {
+    sink.process(1024);
+  }
+
+  write_characterization(argv[2], SAMPLING_RATE, input, output);
+}
@@ -0,0 +1,395 @@
+#include "FFT.h"
+#include "PluginStages.h"
+#include "stages/Instrumentation.h"
+
+#include <ATK/Core/InPointerFilter.h>
+#include <ATK/Core/OutPointerFilter.h>
+#include <ATK/EQ/ButterworthFilter.h>
+#include <ATK/EQ/IIRFilter.h>
+#include <ATK/Modelling/ModellerFilter.h>
+#include <ATK/Tools/DecimationFilter.h>
+#include <ATK/Tools/OversamplingFilter.h>
+
+#include <boost/math/constants/constants.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if !defined(STAGES_COUNT_ITERATIONS) || !defined(STAGES_TUNABLE_SOLVER)
+#error "The stages must be compiled with STAGES_COUNT_ITERATIONS and STAGES_TUNABLE_SOLVER"
+#endif
+
+namespace
+{
+constexpr size_t SAMPLING_RATE = 48000;
+constexpr size_t PLUGIN_OVERSAMPLING = 8;
+/// Analysis window, in host samples, the tone is periodic in it so that no window function is needed
+constexpr size_t ANALYSIS_SIZE = 65536;
+constexpr size_t WARMUP_SIZE = 16384;
+/// Bin of the tone, a prime so that the aliased harmonics fall between the harmonics (3516 Hz)
+constexpr size_t TONE_BIN = 4801;
+constexpr gsl::index BLOCK_SIZE = 1024;
+constexpr double DIST_LEVEL = 100;
+
+struct Settings
+{
+  double eps;
+  gsl::index max_iteration;
+  size_t oversampling;
+};
+
+constexpr Settings REFERENCE{1e-12, 200, 32};
+constexpr std::array<double, 4> EPS{1e-4, 1e-6, 1e-8, 1e-10};
+constexpr std::array<gsl::index, 5> MAX_ITERATIONS{1, 2, 3, 5, 10};
+constexpr std::array<size_t, 4> OVERSAMPLINGS{2, 4, 8, 16};
+/// Stages solved with Newton iterations, the others are linear and don't depend on the solver settings
+constexpr std::array<gsl::index, 3> NONLINEAR_STAGES{2, 5, 6};
+
+struct Cost
+{
+  double ns{0};
+  std::int64_t iterations{0};
+};
+
+/// Runs filter on input, adding its time and its Newton iterations to cost
+std::vector<double> run(ATK::BaseFilter& filter,
+    gsl::index input_port,
+    gsl::index output_port,
+    size_t input_rate,
+    size_t output_rate,
+    const std::vector<double>& input,
+    Cost& cost)
+{
+  const size_t ratio = std::max(input_rate, output_rate) / std::min(input_rate, output_rate);
+  const size_t output_size = output_rate > input_rate ? input.size() * ratio : input.size() / ratio;
+  std::vector<double> output(output_size);
+
+  ATK::InPointerFilter<double> generator(input.data(), 1, input.size(), false);
+  generator.set_output_sampling_rate(input_rate);
+  filter.set_input_sampling_rate(input_rate);
+  filter.set_output_sampling_rate(output_rate);
+  filter.set_input_port(input_port, &generator, 0);
+  ATK::OutPointerFilter<double> sink(output.data(), 1, output.size(), false);
+  sink.set_input_sampling_rate(output_rate);
+  sink.set_input_port(0, &filter, output_port);
+
+  const std::int64_t start_iterations = Stages::get_nb_iterations(filter);
+  const auto start = std::chrono::steady_clock::now();
+  for(size_t i = 0; i < output.size(); i += BLOCK_SIZE)
+  {
+    sink.process(std::min<gsl::index>(BLOCK_SIZE, output.size() - i));
+  }
+  const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  cost.ns += elapsed.count();
+  cost.iterations += Stages::get_nb_iterations(filter) - start_iterations;
+  return output;
+}
+
+/// Runs a stage created with the current solver settings
+std::vector<double> run_stage(
+    StageFactory factory, gsl::index stage, size_t sampling_rate, const std::vector<double>& input, Cost& cost)
+{
+  std::unique_ptr<ATK::ModellerFilter<double>> filter = factory();
+  if(stage == 4)
+  {
+    filter->set_parameter(0, dist_level_parameter(DIST_LEVEL));
+  }
+  return run(*filter,
+      filter->find_input_pin("vin"),
+      filter->find_dynamic_pin("vout"),
+      sampling_rate,
+      sampling_rate,
+      input,
+      cost);
+}
+
+template<typename Coefficients>
+std::vector<double> oversample(size_t oversampling, const std::vector<double>& input, Cost& cost)
+{
+  ATK::OversamplingFilter<double, Coefficients> filter;
+  return run(filter, 0, 0, SAMPLING_RATE, SAMPLING_RATE * oversampling, input, cost);
+}
+
+/// Same resampling as the plugin, with the OversamplingFilter of the oversampling factor
+std::vector<double> oversample_any(size_t oversampling, const std::vector<double>& input, Cost& cost)
+{
+  switch(oversampling)
+  {
+  case 2:
+    return oversample<ATK::Oversampling6points5order_2<double>>(oversampling, input, cost);
+  case 4:
+    return oversample<ATK::Oversampling6points5order_4<double>>(oversampling, input, cost);
+  case 8:
+    return oversample<ATK::Oversampling6points5order_8<double>>(oversampling, input, cost);
+  case 16:
+    return oversample<ATK::Oversampling6points5order_16<double>>(oversampling, input, cost);
+  default:
+    return oversample<ATK::Oversampling6points5order_32<double>>(oversampling, input, cost);
+  }
+}
+
+std::vector<double> decimate(size_t oversampling, const std::vector<double>& input, Cost& cost)
+{
+  ATK::IIRFilter<ATK::ButterworthLowPassCoefficients<double>> lowpass;
+  lowpass.set_input_sampling_rate(SAMPLING_RATE * oversampling);
+  lowpass.set_cut_frequency(20000);
+  lowpass.set_order(6);
+  const std::vector<double> filtered
+      = run(lowpass, 0, 0, SAMPLING_RATE * oversampling, SAMPLING_RATE * oversampling, input, cost);
+  ATK::DecimationFilter<double> decimation;
+  return run(decimation, 0, 0, SAMPLING_RATE * oversampling, SAMPLING_RATE, filtered, cost);
+}
+
+/// Inputs of the six stages and the output of the chain, at the host sampling rate for stage 1 and the output
+struct ChainRun
+{
+  std::array<std::vector<double>, 6> inputs;
+  std::vector<double> output;
+  Cost cost;
+};
+
+ChainRun run_chain(const PluginStages& plugin, const Settings& settings, const std::vector<double>& input)
+{
+  Stages::eps = settings.eps;
+  Stages::max_iteration = settings.max_iteration;
+
+  ChainRun chain;
+  chain.inputs[0] = input;
+  const std::vector<double> high_passed = run_stage(plugin.stages[0], 1, SAMPLING_RATE, input, chain.cost);
+  chain.inputs[1] = oversample_any(settings.oversampling, high_passed, chain.cost);
+  for(gsl::index stage = 2; stage <= 6; ++stage)
+  {
+    std::vector<double> output = run_stage(
+        plugin.stages[stage - 1], stage, SAMPLING_RATE * settings.oversampling, chain.inputs[stage - 1], chain.cost);
+    if(stage < 6)
+    {
+      chain.inputs[stage] = std::move(output);
+    }
+    else
+    {
+      chain.output = decimate(settings.oversampling, output, chain.cost);
+    }
+  }
+  return chain;
+}
+
+/// Full scale tone at TONE_BIN, the warmup followed by the analysis window
+std::vector<double> make_tone()
+{
+  const double pi = boost::math::constants::pi<double>();
+  std::vector<double> tone(WARMUP_SIZE + ANALYSIS_SIZE);
+  for(size_t i = 0; i < tone.size(); ++i)
+  {
+    tone[i] = std::sin(2 * pi * TONE_BIN * i / ANALYSIS_SIZE);
+  }
+  return tone;
+}
+
+/// Magnitudes of the spectrum of the analysis window, from DC to Nyquist
+std::vector<double> spectrum(const std::vector<double>& signal)
+{
+  std::vector<std::complex<double>> data(signal.end() - ANALYSIS_SIZE, signal.end());
+  fft(data);
+  std::vector<double> magnitudes(ANALYSIS_SIZE / 2 + 1);
+  for(size_t i = 0; i < magnitudes.size(); ++i)
+  {
+    magnitudes[i] = std::abs(data[i]);
+  }
+  return magnitudes;
+}
+
+struct Distortion
+{
+  double thd_db;
+  double aliasing_db;
+};
+
+/// THD of the harmonics below Nyquist, and energy of all the other bins but DC, relative to the fundamental
+Distortion analyze(const std::vector<double>& magnitudes)
+{
+  double harmonics = 0;
+  double others = 0;
+  for(size_t i = 1; i < magnitudes.size(); ++i)
+  {
+    const double energy = magnitudes[i] * magnitudes[i];
+    if(i == TONE_BIN)
+    {
+      continue;
+    }
+    (i % TONE_BIN == 0 ? harmonics : others) += energy;
+  }
+  const double fundamental = magnitudes[TONE_BIN] * magnitudes[TONE_BIN];
+  return {10 * std::log10(harmonics / fundamental), 10 * std::log10(others / fundamental)};
+}
+
+/// Ratio between the reference and its difference with signal over the analysis window, in dB
+double snr(const std::vector<double>& reference, const std::vector<double>& signal)
+{
+  double energy = 0;
+  double error = 0;
+  for(size_t i = reference.size() - ANALYSIS_SIZE; i < reference.size(); ++i)
+  {
+    energy += reference[i] * reference[i];
+    error += (signal[i] - reference[i]) * (signal[i] - reference[i]);
+  }
+  return 10 * std::log10(energy / error);
+}
+
+/// SNR between magnitude spectra, insensitive to the different delays of the resampling filters
+double spectral_snr(const std::vector<double>& reference, const std::vector<double>& magnitudes)
+{
+  double energy = 0;
+  double error = 0;
+  for(size_t i = 0; i < reference.size(); ++i)
+  {
+    energy += reference[i] * reference[i];
+    error += (magnitudes[i] - reference[i]) * (magnitudes[i] - reference[i]);
+  }
+  return 10 * std::log10(energy / error);
+}
+
+struct Point
+{
+  std::string plugin;
+  std::string target;
+  Settings settings;
+  double ns_per_sample;
+  double iterations_per_sample;
+  double snr_db;
+  double aliasing_db;
+  double thd_deviation_db;
+  bool pareto{true};
+};
+
+/// Flags the points of each target that no other point beats on both the cost and the SNR
+void flag_pareto(std::vector<Point>& points)
+{
+  for(auto& point : points)
+  {
+    for(const auto& other : points)
+    {
+      if(other.plugin == point.plugin && other.target == point.target && other.ns_per_sample <= point.ns_per_sample
+          && other.snr_db >= point.snr_db
+          && (other.ns_per_sample < point.ns_per_sample || other.snr_db > point.snr_db))
+      {
+        point.pareto = false;
+        break;
+      }
+    }
+  }
+}
+} // namespace
+
+/// Sweeps the Newton tolerance, the maximum number of iterations and the oversampling against a precise reference
+/**
+ * Usage: pareto.exe results.csv
+ * The input is a full scale 3516 Hz tone with distLevel at 100%, whose harmonics alias below 24 kHz. The reference
+ * uses a tolerance of 1e-12, up to 200 iterations and 32x oversampling.
+ * - For the full chain (stages, oversampling and decimation, without the tone stack, which is linear at the host
+ *   sampling rate), the SNR is computed between the magnitude spectra, as the resampling filters have different
+ *   delays, and the aliasing energy and the THD deviation from the reference are reported.
+ * - For each nonlinear stage, at the 8x of the plugin, the stage gets the input of the reference chain, and the SNR
+ *   is computed on the waveforms against the stage with the reference solver settings.
+ * The cost is in ns per host sample for the chain, and per stage sample for the stages.
+ */
+int main(int argc, const char** argv)
+{
+  const std::vector<double> tone = make_tone();
+  std::vector<Point> points;
+
+  for(const auto& plugin : PLUGINS)
+  {
+    const ChainRun reference = run_chain(plugin, REFERENCE, tone);
+    const std::vector<double> reference_spectrum = spectrum(reference.output);
+    const Distortion reference_distortion = analyze(reference_spectrum);
+    std::cout << plugin.name << " reference: THD " << reference_distortion.thd_db << " dB, aliasing "
+              << reference_distortion.aliasing_db << " dB" << std::endl;
+
+    // Stage inputs at the rate of the plugin, from the reference solver
+    const ChainRun plugin_rate = run_chain(plugin, {REFERENCE.eps, REFERENCE.max_iteration, PLUGIN_OVERSAMPLING}, tone);
+    const size_t stage_sampling_rate = SAMPLING_RATE * PLUGIN_OVERSAMPLING;
+
+    // The outputs of the stages with the reference solver don't depend on the swept settings
+    std::array<std::vector<double>, 6> stage_references;
+    Stages::eps = REFERENCE.eps;
+    Stages::max_iteration = REFERENCE.max_iteration;
+    for(gsl::index stage : NONLINEAR_STAGES)
+    {
+      Cost reference_cost;
+      stage_references[stage - 1] = run_stage(
+          plugin.stages[stage - 1], stage, stage_sampling_rate, plugin_rate.inputs[stage - 1], reference_cost);
+    }
+
+    for(double eps : EPS)
+    {
+      for(gsl::index max_iteration : MAX_ITERATIONS)
+      {
+        for(size_t oversampling : OVERSAMPLINGS)
+        {
+          const ChainRun chain = run_chain(plugin, {eps, max_iteration, oversampling}, tone);
+          const std::vector<double> magnitudes = spectrum(chain.output);
+          const Distortion distortion = analyze(magnitudes);
+          points.push_back({plugin.name,
+              "chain",
+              {eps, max_iteration, oversampling},
+              chain.cost.ns / tone.size(),
+              static_cast<double>(chain.cost.iterations) / tone.size(),
+              spectral_snr(reference_spectrum, magnitudes),
+              distortion.aliasing_db,
+              distortion.thd_db - reference_distortion.thd_db});
+          std::cout << plugin.name << " chain eps " << eps << " iterations " << max_iteration << " x" << oversampling
+                    << ": SNR " << points.back().snr_db << " dB, " << points.back().ns_per_sample << " ns/sample"
+                    << std::endl;
+        }
+
+        for(gsl::index stage : NONLINEAR_STAGES)
+        {
+          const auto& input = plugin_rate.inputs[stage - 1];
+          Cost cost;
+          Stages::eps = eps;
+          Stages::max_iteration = max_iteration;
+          const std::vector<double> output
+              = run_stage(plugin.stages[stage - 1], stage, stage_sampling_rate, input, cost);
+          points.push_back({plugin.name,
+              "stage" + std::to_string(stage),
+              {eps, max_iteration, PLUGIN_OVERSAMPLING},
+              cost.ns / input.size(),
+              static_cast<double>(cost.iterations) / input.size(),
+              snr(stage_references[stage - 1], output),
+              0,
+              0});
+        }
+      }
+    }
+  }
+
+  flag_pareto(points);
+  std::ofstream out(argv[1]);
+  out << "plugin,target,eps,max_iteration,oversampling,ns_per_sample,iterations_per_sample,snr_db,aliasing_db,"
+         "thd_deviation_db,pareto"
+      << std::endl;
+  for(const auto& point : points)
+  {
+    out << point.plugin << "," << point.target << "," << point.settings.eps << "," << point.settings.max_iteration
+        << "," << point.settings.oversampling << "," << point.ns_per_sample << "," << point.iterations_per_sample
+        << "," << point.snr_db << ",";
+    if(point.target == "chain")
+    {
+      out << point.aliasing_db << "," << point.thd_deviation_db;
+    }
+    else
+    {
+      out << ",";
+    }
+    out << "," << point.pareto << std::endl;
+  }
+}
@@ -0,0 +1,143 @@
+#!/usr/bin/python3
+
+# USAGE:
+# reduce.py netlist.cir max_error reduced.cir
+#
+# Removes the passive components of a netlist that change its small signal response between 20 Hz and
+# 20 kHz by less than max_error dB, and generates:
+# - reduced.cir, the netlist for ATKModellingGenerator, with the removed components commented out,
+# - reduced.txt, the removed components, the measured error and the number of dynamic pins.
+#
+# A component is either opened (removed) or shorted (its nodes merged). The components are removed
+# greedily, the one with the smallest error first, and the error is always measured against the
+# original netlist, so the errors don't add up. Sources, opamps, potentiometers and nonlinear
+# components are kept, and the response is measured at the operating point of the nonlinear ones.
+
+import math
+import re
+import sys
+
+import numpy as np
+
+from linearize import ac_response, parse_netlist, small_signal
+
+NODE_COUNTS = {"R": 2, "C": 2, "L": 2, "D": 2, "V": 2, "G": 4, "Z": 3, "Q": 3, "P": 3}
+
+def rename(elements, node, target):
+  "Returns the elements with node replaced by target"
+  renamed = []
+  for e in elements:
+    e = dict(e)
+    e["nodes"] = [target if n == node else n for n in e["nodes"]]
+    renamed.append(e)
+  return renamed
+
+def apply(elements, action, element):
+  "Returns the elements with element opened or shorted, and the merged nodes if any"
+  remaining = [e for e in elements if e["name"] != element["name"]]
+  if action == "open":
+    return remaining, None
+  node, target = element["nodes"]
+  if node in protected_nodes(elements):
+    node, target = target, node
+  return rename(remaining, node, target), (node, target)
+
+def protected_nodes(elements):
+  "Ground, input, output and supplies, they can't disappear in a merge"
+  return set(["0", "vin", "vout"] + [e["nodes"][0] for e in elements if e["kind"] == "V"])
+
+def candidates(elements):
+  protected = protected_nodes(elements)
+  for e in elements:
+    if e["kind"] not in "RCL":
+      continue
+    yield "open", e
+    if not (e["nodes"][0] in protected and e["nodes"][1] in protected):
+      yield "short", e
+
+def dynamic_pins(elements):
+  "Nodes solved by the modeller, all but the ground and the sources"
+  static = set(["0"] + [e["nodes"][0] for e in elements if e["kind"] == "V"])
+  return len(set(n for e in elements for n in e["nodes"]) - static)
+
+def error(elements, models, reference, frequencies):
+  "Maximum difference in dB with the reference response, None if the netlist can't be solved"
+  try:
+    response = ac_response(small_signal(elements, models), frequencies)
+  except (np.linalg.LinAlgError, ZeroDivisionError):
+    return None
+  if not np.all(np.isfinite(response)) or np.any(response == 0):
+    return None
+  return np.max(np.abs(20 * np.log10(np.abs(response / reference))))
+
+def reduce(elements, models, max_error, frequencies):
+  "Greedily removes components while the error stays below max_error, returns the reduced netlist and the steps"
+  reference = ac_response(small_signal(elements, models), frequencies)
+  steps = []
+  while True:
+    best = None
+    for action, element in candidates(elements):
+      reduced, merge = apply(elements, action, element)
+      value = error(reduced, models, reference, frequencies)
+      if value is not None and value <= max_error and (best is None or value < best[0]):
+        best = (value, action, element, reduced, merge)
+    if best is None:
+      return elements, steps
+    value, action, element, elements, merge = best
+    steps.append((action, element, merge, value))
+
+def write_netlist(filename, source, steps):
+  "Writes the original netlist with the removed components commented out and the merged nodes renamed"
+  removed = dict((element["name"], action) for action, element, merge, value in steps)
+  merges = [merge for action, element, merge, value in steps if merge is not None]
+  spellings = {}
+  lines = open(source).read().splitlines()
+  for line in lines:
+    tokens = line.split()
+    if tokens and tokens[0][0].upper() in NODE_COUNTS:
+      for token in tokens[1:1 + NODE_COUNTS[tokens[0][0].upper()]]:
+        spellings.setdefault(token.lower(), token)
+
+  def target(node):
+    for merged, kept in merges:
+      if node == merged:
+        node = kept
+    return node
+
+  with open(filename, "w") as output:
+    for line in lines:
+      # Tokens and separators alternate, so that the line keeps its layout
+      tokens = re.split(r"(\s+)", line)
+      name = tokens[0]
+      if name in removed:
+        output.write("* Reduced (%s): %s\n" % (removed[name], line))
+        continue
+      if name and name[0].upper() in NODE_COUNTS:
+        for i in range(2, 2 + 2 * NODE_COUNTS[name[0].upper()], 2):
+          kept = target(tokens[i].lower())
+          if kept != tokens[i].lower():
+            tokens[i] = spellings[kept]
+        line = "".join(tokens)
+      output.write(line + "\n")
+
+def write_report(filename, source, max_error, original, reduced, steps):
+  with open(filename, "w") as output:
+    output.write("Reduction of %s, maximum error %g dB between 20 Hz and 20 kHz\n" % (source, max_error))
+    output.write("The error is measured on the small signal response at the operating point, check the large signal\n")
+    output.write("behavior of the reduced netlist when a removed component is close to a nonlinear one\n\n")
+    for action, element, merge, value in steps:
+      output.write("%s %s (%s)%s: %.4f dB\n" % (action, element["name"], element["line"].split()[-1],
+          "" if merge is None else ", %s merged into %s" % merge, value))
+    if not steps:
+      output.write("No component can be removed\n")
+    output.write("\nDynamic pins: %d -> %d\n" % (dynamic_pins(original), dynamic_pins(reduced)))
+    output.write("Capacitors: %d -> %d\n" % tuple(len([e for e in netlist if e["kind"] == "C"]) for netlist in (original, reduced)))
+    output.write("Final error: %.4f dB\n" % (steps[-1][3] if steps else 0))
+
+if __name__ == "__main__":
+  source, max_error, target = sys.argv[1], float(sys.argv[2]), sys.argv[3]
+  elements, models = parse_netlist(source)
+  frequencies = np.logspace(math.log10(20), math.log10(20000), 301)
+  reduced, steps = reduce(elements, models, max_error, frequencies)
+  write_netlist(target, source, steps)
+  write_report(target[:-len(".cir")] + ".txt", source, max_error, elements, reduced, steps)
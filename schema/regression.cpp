@@ -0,0 +1,285 @@
+#include "CharacterizationFile.h"
+#include "FFT.h"
+#include "ProcessingChain.h"
+#include "static_elements.h"
+
+#include <ATK/Core/InPointerFilter.h>
+#include <ATK/Core/OutPointerFilter.h>
+#include <ATK/Modelling/ModellerFilter.h>
+
+#include <boost/math/constants/constants.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// PLUGIN is the namespace of the chain, MT2 or MTB, and MID_FREQ its default mid frequency, both set by the Makefile
+#define STRINGIFY_(x) #x
+#define STRINGIFY(x) STRINGIFY_(x)
+
+namespace
+{
+/// Sampling rate of the characterizations of the stages, as generate.cpp
+constexpr size_t STAGE_SAMPLING_RATE = 96000;
+/// Host sampling rate of the chains
+constexpr long CHAIN_SAMPLING_RATE = 48000;
+constexpr double DURATION = .125;
+constexpr gsl::index BLOCK_SIZE = 256;
+constexpr double DEFAULT_MAX_ERROR = 1e-6;
+constexpr double DEFAULT_SPECTRAL_DEVIATION = .1;
+/// Bands quieter than the loudest one by more than this are not compared, in dB
+constexpr double SPECTRAL_FLOOR = 100;
+
+const std::array<const char*, 4> INPUTS{"sweep", "chord", "bursts", "noise"};
+
+using StageFactory = std::unique_ptr<ATK::ModellerFilter<double>> (*)();
+const std::array<StageFactory, 6> STAGES{PLUGIN::createStaticFilter_stage1,
+    PLUGIN::createStaticFilter_stage2,
+    PLUGIN::createStaticFilter_stage3,
+    PLUGIN::createStaticFilter_stage4,
+    PLUGIN::createStaticFilter_stage5,
+    PLUGIN::createStaticFilter_stage6};
+
+struct Chain
+{
+  const char* name;
+  PLUGIN::ProcessingChain::Resampling resampling;
+  PLUGIN::ProcessingChain::Model model;
+};
+
+const std::array<Chain, 3> CHAINS{{
+    {"chain", PLUGIN::ProcessingChain::Resampling::MinimumPhase, PLUGIN::ProcessingChain::Model::Full},
+    {"chain-linear-phase", PLUGIN::ProcessingChain::Resampling::LinearPhase, PLUGIN::ProcessingChain::Model::Full},
+    {"chain-eco", PLUGIN::ProcessingChain::Resampling::MinimumPhase, PLUGIN::ProcessingChain::Model::Eco},
+}};
+
+/// The inputs of the references, only used when they are recorded
+std::vector<double> make_input(const std::string& name, double sampling_rate)
+{
+  const double pi = boost::math::constants::pi<double>();
+  std::vector<double> input(static_cast<size_t>(sampling_rate * DURATION));
+  // Park and Miller generator, so that the noise doesn't depend on the standard library
+  std::uint64_t seed = 1;
+  for(size_t i = 0; i < input.size(); ++i)
+  {
+    const double t = i / sampling_rate;
+    if(name == "sweep")
+    {
+      const double end = std::min(20000., .45 * sampling_rate);
+      const double rate = std::log(end / 20) / DURATION;
+      input[i] = .5 * std::sin(2 * pi * 20 / rate * (std::exp(rate * t) - 1));
+    }
+    else if(name == "chord")
+    {
+      input[i] = (std::sin(2 * pi * 82.41 * t) + std::sin(2 * pi * 123.47 * t) + std::sin(2 * pi * 164.81 * t)) / 3;
+    }
+    else if(name == "bursts")
+    {
+      const bool burst = std::fmod(t, .05) < .025;
+      input[i] = burst ? (std::fmod(t * 110, 1.) < .5 ? 1. : -1.) : 0.;
+    }
+    else
+    {
+      seed = seed * 48271 % 2147483647;
+      input[i] = .25 * (2. * seed / 2147483647 - 1);
+    }
+  }
+  return input;
+}
+
+/// Output of a stage as generate.cpp characterizes it, with all its parameters at 0.5
+std::vector<double> render_stage(StageFactory factory, const std::vector<double>& input)
+{
+  std::vector<double> output(input.size());
+  ATK::InPointerFilter<double> generator(input.data(), 1, input.size(), false);
+  generator.set_output_sampling_rate(STAGE_SAMPLING_RATE);
+
+  std::unique_ptr<ATK::ModellerFilter<double>> filter = factory();
+  for(gsl::index i = 0; i < filter->get_number_parameters(); ++i)
+  {
+    filter->set_parameter(i, 0.5);
+  }
+  filter->set_input_sampling_rate(STAGE_SAMPLING_RATE);
+  filter->set_output_sampling_rate(STAGE_SAMPLING_RATE);
+  filter->set_input_port(filter->find_input_pin("vin"), &generator, 0);
+
+  ATK::OutPointerFilter<double> sink(output.data(), 1, output.size(), false);
+  sink.set_input_sampling_rate(STAGE_SAMPLING_RATE);
+  sink.set_input_port(0, filter.get(), filter->find_dynamic_pin("vout"));
+  for(size_t i = 0; i < output.size(); i += BLOCK_SIZE)
+  {
+    sink.process(std::min<gsl::index>(BLOCK_SIZE, output.size() - i));
+  }
+  return output;
+}
+
+/// Output of the chain as the host drives it, with the default parameters of the plugin
+std::vector<double> render_chain(const Chain& description, const std::vector<double>& input)
+{
+  PLUGIN::ProcessingChain chain;
+  chain.configure(CHAIN_SAMPLING_RATE, BLOCK_SIZE, description.resampling, description.model);
+  chain.setParameters({50.f, 0.f, 0.f, 0.f, MID_FREQ, 3.1f, .25f, 1.f});
+
+  std::vector<float> input_block(BLOCK_SIZE);
+  std::vector<float> output_block(BLOCK_SIZE);
+  std::vector<double> output(input.size());
+  for(size_t i = 0; i < input.size(); i += BLOCK_SIZE)
+  {
+    const auto size = static_cast<int>(std::min<size_t>(BLOCK_SIZE, input.size() - i));
+    std::copy(input.begin() + i, input.begin() + i + size, input_block.begin());
+    chain.process(input_block.data(), output_block.data(), size);
+    std::copy(output_block.begin(), output_block.begin() + size, output.begin() + i);
+  }
+  return output;
+}
+
+/// Energies of third octave bands from 20 Hz to Nyquist
+std::vector<double> band_energies(const std::vector<double>& signal, double sampling_rate)
+{
+  size_t size = 1;
+  while(size < signal.size())
+  {
+    size <<= 1;
+  }
+  std::vector<std::complex<double>> data(size);
+  std::copy(signal.begin(), signal.end(), data.begin());
+  fft(data);
+
+  std::vector<double> energies;
+  for(double low = 20; low < sampling_rate / 2; low *= std::pow(2., 1. / 3))
+  {
+    const auto first = static_cast<size_t>(low * size / sampling_rate);
+    const auto last = std::min(size / 2 + 1, static_cast<size_t>(low * std::pow(2., 1. / 3) * size / sampling_rate));
+    double energy = 0;
+    for(size_t i = first; i < last; ++i)
+    {
+      energy += std::norm(data[i]);
+    }
+    energies.push_back(energy);
+  }
+  return energies;
+}
+
+struct Deviation
+{
+  double max_error;
+  /// Largest difference between the third octave bands of the output and of the reference, in dB
+  double spectral_deviation;
+};
+
+Deviation compare(const std::vector<double>& output, const std::vector<double>& reference, double sampling_rate)
+{
+  Deviation deviation{0, 0};
+  for(size_t i = 0; i < output.size(); ++i)
+  {
+    deviation.max_error = std::max(deviation.max_error, std::abs(output[i] - reference[i]));
+  }
+
+  const auto output_bands = band_energies(output, sampling_rate);
+  const auto reference_bands = band_energies(reference, sampling_rate);
+  const double floor
+      = *std::max_element(reference_bands.begin(), reference_bands.end()) * std::pow(10, -SPECTRAL_FLOOR / 10);
+  for(size_t i = 0; i < reference_bands.size(); ++i)
+  {
+    if(reference_bands[i] > floor)
+    {
+      deviation.spectral_deviation = std::max(deviation.spectral_deviation,
+          std::abs(10 * std::log10(std::max(output_bands[i], floor) / reference_bands[i])));
+    }
+  }
+  return deviation;
+}
+} // namespace
+
+/// Renders fixed inputs through each stage and each chain of the plugin, and compares them with references
+/**
+ * Usage: regression.exe record directory
+ *        regression.exe check directory [max_error] [spectral_deviation_db]
+ * record writes directory/target-input.dat for every target (stage1 to stage6, chain, chain-linear-phase and
+ * chain-eco) and every input, in the format of CharacterizationFile.h, with the input and the reference output.
+ * check renders the inputs of these files again and fails if the maximum absolute error (1e-6 by default) or the
+ * largest deviation of the third octave bands (0.1 dB by default) exceeds its tolerance. The stages are rendered at
+ * 96 kHz as generate.cpp does, and the chains at 48 kHz with the default parameters of the plugin.
+ */
+int main(int argc, const char** argv)
+{
+  if(argc < 3)
+  {
+    std::cerr << "Usage: " << argv[0] << " record|check directory [max_error] [spectral_deviation_db]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string mode = argv[1];
+  const std::string directory = argv[2];
+  const double max_error = argc > 3 ? std::atof(argv[3]) : DEFAULT_MAX_ERROR;
+  const double spectral_deviation = argc > 4 ? std::atof(argv[4]) : DEFAULT_SPECTRAL_DEVIATION;
+
+  struct Target
+  {
+    std::string name;
+    double sampling_rate;
+    std::function<std::vector<double>(const std::vector<double>&)> render;
+  };
+  std::vector<Target> targets;
+  for(size_t stage = 0; stage < STAGES.size(); ++stage)
+  {
+    targets.push_back({"stage" + std::to_string(stage + 1), STAGE_SAMPLING_RATE, [stage](const auto& input) {
+                         return render_stage(STAGES[stage], input);
+                       }});
+  }
+  for(const auto& chain : CHAINS)
+  {
+    targets.push_back({chain.name, CHAIN_SAMPLING_RATE, [&chain](const auto& input) {
+                         return render_chain(chain, input);
+                       }});
+  }
+
+  size_t failures = 0;
+  for(const auto& target : targets)
+  {
+    for(const std::string input_name : INPUTS)
+    {
+      const std::string filename = directory + "/" + target.name + "-" + input_name + ".dat";
+      if(mode == "record")
+      {
+        const std::vector<double> input = make_input(input_name, target.sampling_rate);
+        write_characterization(
+            filename, static_cast<std::uint32_t>(target.sampling_rate), input, target.render(input));
+        std::cout << "Recorded " << filename << std::endl;
+        continue;
+      }
+
+      std::vector<double> input;
+      std::vector<double> reference;
+      try
+      {
+        read_characterization(filename, input, reference);
+      }
+      catch(const std::exception& e)
+      {
+        std::cerr << e.what() << ", the references are recorded with make golden GOLDEN_REVISION=<revision>" << std::endl;
+        return EXIT_FAILURE;
+      }
+      const Deviation deviation = compare(target.render(input), reference, target.sampling_rate);
+      const bool passed = deviation.max_error <= max_error && deviation.spectral_deviation <= spectral_deviation;
+      failures += passed ? 0 : 1;
+      std::cout << (passed ? "PASS " : "FAIL ") << STRINGIFY(PLUGIN) << " " << target.name << " " << input_name
+                << ": max error " << deviation.max_error << ", spectral deviation " << deviation.spectral_deviation
+                << " dB" << std::endl;
+    }
+  }
+
+  if(failures > 0)
+  {
+    std::cout << failures << " outputs differ from their reference" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
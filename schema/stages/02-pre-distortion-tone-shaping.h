@@ -0,0 +1,436 @@
+/**
+ * \file 02-pre-distortion-tone-shaping.h
+ * Generated from 02-pre-distortion-tone-shaping.cir by ATKModellingGenerator, kernelize.py and templatize.py
+ * The component values are a template parameter, the plugins instantiate the stage with the values of their netlist
+ */
+
+#ifndef STAGES_PRE_DISTORTION_TONE_SHAPING
+#define STAGES_PRE_DISTORTION_TONE_SHAPING
+
+#include "Instrumentation.h"
+
+#include <cstdlib>
+#include <memory>
+
+#include <ATK/Core/Utilities.h>
+#include <ATK/Modelling/ModellerFilter.h>
+#include <ATK/Modelling/StaticComponent/StaticCapacitor.h>
+#include <ATK/Modelling/StaticComponent/StaticCoil.h>
+#include <ATK/Modelling/StaticComponent/StaticCurrent.h>
+#include <ATK/Modelling/StaticComponent/StaticDiode.h>
+#include <ATK/Modelling/StaticComponent/StaticEbersMollTransistor.h>
+#include <ATK/Modelling/StaticComponent/StaticMOSFETTransistor.h>
+#include <ATK/Modelling/StaticComponent/StaticResistor.h>
+#include <ATK/Modelling/StaticComponent/StaticResistorCapacitor.h>
+
+#include <Eigen/Eigen>
+
+namespace Stages
+{
+template<typename DataType_, typename Values>
+class PreDistortionToneShapingFilter final
+  : public ATK::ModellerFilter<DataType_>
+#ifdef STAGES_COUNT_ITERATIONS
+  , public IterationCounter
+#endif
+{
+  using Parent = ATK::ModellerFilter<DataType_>;
+  using typename Parent::DataType;
+  using Parent::converted_inputs;
+  using Parent::input_sampling_rate;
+  using Parent::output_sampling_rate;
+  using Parent::outputs;
+
+#ifdef STAGES_TUNABLE_SOLVER
+  static constexpr const gsl::index& MAX_ITERATION = Stages::max_iteration;
+#else
+  static constexpr gsl::index MAX_ITERATION = 10;
+#endif
+  static constexpr gsl::index MAX_ITERATION_STEADY_STATE{200};
+  static constexpr gsl::index INIT_WARMUP{10};
+#ifdef STAGES_TUNABLE_SOLVER
+  static constexpr const double& EPS = Stages::eps;
+#else
+  static constexpr DataType EPS{1e-8};
+#endif
+  static constexpr DataType MAX_DELTA{1e-1};
+
+  bool initialized{false};
+
+  Eigen::Matrix<DataType, 3, 1> static_state{Eigen::Matrix<DataType, 3, 1>::Zero()};
+  mutable Eigen::Matrix<DataType, 1, 1> input_state{Eigen::Matrix<DataType, 1, 1>::Zero()};
+  mutable Eigen::Matrix<DataType, 5, 1> dynamic_state{Eigen::Matrix<DataType, 5, 1>::Zero()};
+  ATK::StaticEBNPN<DataType> q010{Values::q010[0], Values::q010[1], Values::q010[2], Values::q010[3], Values::q010[4]};
+  ATK::StaticResistor<DataType> r053{Values::r053[0]};
+  ATK::StaticCapacitor<DataType> c032{Values::c032[0]};
+  ATK::StaticResistor<DataType> r046{Values::r046[0]};
+  ATK::StaticResistor<DataType> r044{Values::r044[0]};
+  ATK::StaticCapacitor<DataType> c035{Values::c035[0]};
+  ATK::StaticResistor<DataType> r054{Values::r054[0]};
+  ATK::StaticCapacitor<DataType> c034{Values::c034[0]};
+
+public:
+  PreDistortionToneShapingFilter(): Parent(5, 1)
+  {
+    static_state << 0.000000, -4.500000, 4.500000;
+  }
+
+  ~PreDistortionToneShapingFilter() override = default;
+
+  gsl::index get_nb_dynamic_pins() const override
+  {
+    return 5;
+  }
+
+  gsl::index get_nb_input_pins() const override
+  {
+    return 1;
+  }
+
+  gsl::index get_nb_static_pins() const override
+  {
+    return 3;
+  }
+
+  Eigen::Matrix<DataType, Eigen::Dynamic, 1> get_static_state() const override
+  {
+    return static_state;
+  }
+
+  gsl::index get_nb_components() const override
+  {
+    return 9;
+  }
+
+  std::string get_dynamic_pin_name(gsl::index identifier) const override
+  {
+    switch(identifier)
+    {
+    case 4:
+      return "3";
+    case 2:
+      return "2";
+    case 1:
+      return "4";
+    case 3:
+      return "vout";
+    case 0:
+      return "5";
+    default:
+      throw ATK::RuntimeError("No such pin");
+    }
+  }
+
+  std::string get_input_pin_name(gsl::index identifier) const override
+  {
+    switch(identifier)
+    {
+    case 0:
+      return "vin";
+    default:
+      throw ATK::RuntimeError("No such pin");
+    }
+  }
+
+  std::string get_static_pin_name(gsl::index identifier) const override
+  {
+    switch(identifier)
+    {
+    case 1:
+      return "vdd";
+    case 2:
+      return "vcc";
+    case 0:
+      return "0";
+    default:
+      throw ATK::RuntimeError("No such pin");
+    }
+  }
+
+  gsl::index get_number_parameters() const override
+  {
+    return 0;
+  }
+
+  std::string get_parameter_name(gsl::index identifier) const override
+  {
+    switch(identifier)
+    {
+    default:
+      throw ATK::RuntimeError("No such pin");
+    }
+  }
+
+  DataType get_parameter(gsl::index identifier) const override
+  {
+    switch(identifier)
+    {
+    default:
+      throw ATK::RuntimeError("No such pin");
+    }
+  }
+
+  void set_parameter(gsl::index identifier, DataType value) override
+  {
+    switch(identifier)
+    {
+    default:
+      throw ATK::RuntimeError("No such pin");
+    }
+  }
+
+  /// Setup the inner state of the filter, slowly incrementing the static state
+  void setup() override
+  {
+    assert(input_sampling_rate == output_sampling_rate);
+
+    if(!initialized)
+    {
+      setup_inverse<true>();
+      auto target_static_state = static_state;
+
+      for(gsl::index i = 0; i < INIT_WARMUP; ++i)
+      {
+        static_state = target_static_state * static_cast<DataType>((i + 1.) / INIT_WARMUP);
+        init();
+      }
+      static_state = target_static_state;
+    }
+    setup_inverse<false>();
+  }
+
+  template <bool steady_state>
+  void setup_inverse()
+  {
+  }
+
+  void init()
+  {
+    // update_steady_state
+    c032.update_steady_state(1. / input_sampling_rate, dynamic_state[2], dynamic_state[3]);
+    c035.update_steady_state(1. / input_sampling_rate, dynamic_state[4], dynamic_state[0]);
+    c034.update_steady_state(1. / input_sampling_rate, dynamic_state[2], dynamic_state[4]);
+
+    solve<true>(input_state, dynamic_state);
+
+    // update_steady_state
+    c032.update_steady_state(1. / input_sampling_rate, dynamic_state[2], dynamic_state[3]);
+    c035.update_steady_state(1. / input_sampling_rate, dynamic_state[4], dynamic_state[0]);
+    c034.update_steady_state(1. / input_sampling_rate, dynamic_state[2], dynamic_state[4]);
+
+    initialized = true;
+  }
+
+  void process_impl(gsl::index size) const override
+  {
+    // The states are kept in locals for the whole block, so that they can stay in registers
+    const DataType* ATK_RESTRICT input0 = converted_inputs[0];
+    DataType* ATK_RESTRICT output0 = outputs[0];
+    DataType* ATK_RESTRICT output1 = outputs[1];
+    DataType* ATK_RESTRICT output2 = outputs[2];
+    DataType* ATK_RESTRICT output3 = outputs[3];
+    DataType* ATK_RESTRICT output4 = outputs[4];
+    Eigen::Matrix<DataType, 1, 1> input = input_state;
+    Eigen::Matrix<DataType, 5, 1> dynamic = dynamic_state;
+
+    for(gsl::index i = 0; i < size; ++i)
+    {
+      input[0] = input0[i];
+
+      solve<false>(input, dynamic);
+
+      // Update state
+      c032.update_state(dynamic[2], dynamic[3]);
+      c035.update_state(dynamic[4], dynamic[0]);
+      c034.update_state(dynamic[2], dynamic[4]);
+      output0[i] = dynamic[0];
+      output1[i] = dynamic[1];
+      output2[i] = dynamic[2];
+      output3[i] = dynamic[3];
+      output4[i] = dynamic[4];
+    }
+
+    input_state = input;
+    dynamic_state = dynamic;
+  }
+
+  /// Solve for steady state and non steady state the system
+  template <bool steady_state>
+  void solve(const Eigen::Matrix<DataType, 1, 1>& input, Eigen::Matrix<DataType, 5, 1>& dynamic) const
+  {
+    gsl::index iteration = 0;
+
+    const gsl::index current_max_iter = steady_state ? MAX_ITERATION_STEADY_STATE : MAX_ITERATION;
+
+    while(iteration < current_max_iter && !iterate<steady_state>(input, dynamic))
+    {
+      ++iteration;
+    }
+  }
+
+  template <bool steady_state>
+  bool iterate(const Eigen::Matrix<DataType, 1, 1>& input, Eigen::Matrix<DataType, 5, 1>& dynamic) const
+  {
+#ifdef STAGES_COUNT_ITERATIONS
+    ++nb_iterations;
+#endif
+    // Static states
+    auto s0_ = static_state[0];
+    auto s1_ = static_state[1];
+    auto s2_ = static_state[2];
+
+    // Input states
+    auto i0_ = input[0];
+
+    // Dynamic states
+    auto d0_ = dynamic[0];
+    auto d1_ = dynamic[1];
+    auto d2_ = dynamic[2];
+    auto d3_ = dynamic[3];
+    auto d4_ = dynamic[4];
+
+    // Precomputes
+    q010.precompute(dynamic[0], static_state[2], dynamic[1]);
+
+    Eigen::Matrix<DataType, 5, 1> eqs(Eigen::Matrix<DataType, 5, 1>::Zero());
+    auto eq0 = -q010.ib() - r053.get_current(s0_, d0_) - (steady_state ? 0 : c035.get_current(d4_, d0_));
+    auto eq1 = +q010.ib() + q010.ic() - r046.get_current(d4_, d1_) + r054.get_current(d1_, s1_);
+    auto eq2 = +(steady_state ? 0 : c032.get_current(d2_, d3_)) + r044.get_current(d2_, d3_)
+             + (steady_state ? 0 : c034.get_current(d2_, d4_));
+    auto eq3 = input[0] - dynamic[2];
+    auto eq4 = +r046.get_current(d4_, d1_) + (steady_state ? 0 : c035.get_current(d4_, d0_))
+             - (steady_state ? 0 : c034.get_current(d2_, d4_));
+    eqs << eq0, eq1, eq2, eq3, eq4;
+
+    // Check if the equations have converged
+    if((eqs.array().abs() < EPS).all())
+    {
+      return true;
+    }
+
+    auto jac0_0 = 0 - q010.ib_Vbc() - q010.ib_Vbe() - r053.get_gradient() - (steady_state ? 0 : c035.get_gradient());
+    auto jac0_1 = 0 + q010.ib_Vbe();
+    auto jac0_2 = 0;
+    auto jac0_3 = 0;
+    auto jac0_4 = 0 + (steady_state ? 0 : c035.get_gradient());
+    auto jac1_0 = 0 + q010.ib_Vbc() + q010.ib_Vbe() + q010.ic_Vbc() + q010.ic_Vbe();
+    auto jac1_1 = 0 - q010.ib_Vbe() - q010.ic_Vbe() - r046.get_gradient() - r054.get_gradient();
+    auto jac1_2 = 0;
+    auto jac1_3 = 0;
+    auto jac1_4 = 0 + r046.get_gradient();
+    auto jac2_0 = 0;
+    auto jac2_1 = 0;
+    auto jac2_2
+        = 0 - (steady_state ? 0 : c032.get_gradient()) - r044.get_gradient() - (steady_state ? 0 : c034.get_gradient());
+    auto jac2_3 = 0 + (steady_state ? 0 : c032.get_gradient()) + r044.get_gradient();
+    auto jac2_4 = 0 + (steady_state ? 0 : c034.get_gradient());
+    auto jac3_0 = 0;
+    auto jac3_1 = 0;
+    auto jac3_2 = 0 + -1;
+    auto jac3_3 = 0;
+    auto jac3_4 = 0;
+    auto jac4_0 = 0 + (steady_state ? 0 : c035.get_gradient());
+    auto jac4_1 = 0 + r046.get_gradient();
+    auto jac4_2 = 0 + (steady_state ? 0 : c034.get_gradient());
+    auto jac4_3 = 0;
+    auto jac4_4
+        = 0 - r046.get_gradient() - (steady_state ? 0 : c035.get_gradient()) - (steady_state ? 0 : c034.get_gradient());
+    auto det = (1 * jac0_0
+                    * (1 * jac1_1 * (-1 * jac2_3 * (1 * jac3_2 * jac4_4))
+                        + -1 * jac1_4 * (1 * jac2_3 * (-1 * jac3_2 * jac4_1)))
+                + -1 * jac0_1
+                      * (1 * jac1_0 * (-1 * jac2_3 * (1 * jac3_2 * jac4_4))
+                          + -1 * jac1_4 * (1 * jac2_3 * (-1 * jac3_2 * jac4_0)))
+                + 1 * jac0_4
+                      * (1 * jac1_0 * (1 * jac2_3 * (-1 * jac3_2 * jac4_1))
+                          + -1 * jac1_1 * (1 * jac2_3 * (-1 * jac3_2 * jac4_0))));
+    auto invdet = 1 / det;
+    auto com0_0
+        = (1 * jac1_1 * (-1 * jac2_3 * (1 * jac3_2 * jac4_4)) + -1 * jac1_4 * (1 * jac2_3 * (-1 * jac3_2 * jac4_1)));
+    auto com1_0
+        = -1
+        * (1 * jac1_0 * (-1 * jac2_3 * (1 * jac3_2 * jac4_4)) + -1 * jac1_4 * (1 * jac2_3 * (-1 * jac3_2 * jac4_0)));
+    auto com2_0 = 0;
+    auto com3_0
+        = -1
+        * (1 * jac1_0 * (1 * jac2_4 * (-1 * jac3_2 * jac4_1)) + -1 * jac1_1 * (1 * jac2_4 * (-1 * jac3_2 * jac4_0)));
+    auto com4_0
+        = (1 * jac1_0 * (1 * jac2_3 * (-1 * jac3_2 * jac4_1)) + -1 * jac1_1 * (1 * jac2_3 * (-1 * jac3_2 * jac4_0)));
+    auto com0_1
+        = -1
+        * (1 * jac0_1 * (-1 * jac2_3 * (1 * jac3_2 * jac4_4)) + -1 * jac0_4 * (1 * jac2_3 * (-1 * jac3_2 * jac4_1)));
+    auto com1_1
+        = (1 * jac0_0 * (-1 * jac2_3 * (1 * jac3_2 * jac4_4)) + -1 * jac0_4 * (1 * jac2_3 * (-1 * jac3_2 * jac4_0)));
+    auto com2_1 = -1 * 0;
+    auto com3_1
+        = (1 * jac0_0 * (1 * jac2_4 * (-1 * jac3_2 * jac4_1)) + -1 * jac0_1 * (1 * jac2_4 * (-1 * jac3_2 * jac4_0)));
+    auto com4_1
+        = -1
+        * (1 * jac0_0 * (1 * jac2_3 * (-1 * jac3_2 * jac4_1)) + -1 * jac0_1 * (1 * jac2_3 * (-1 * jac3_2 * jac4_0)));
+    auto com0_2 = 0;
+    auto com1_2 = -1 * 0;
+    auto com2_2 = 0;
+    auto com3_2 = -1
+                * (1 * jac0_0 * (1 * jac1_1 * (1 * jac3_2 * jac4_4) + 1 * jac1_4 * (-1 * jac3_2 * jac4_1))
+                    + -1 * jac0_1 * (1 * jac1_0 * (1 * jac3_2 * jac4_4) + 1 * jac1_4 * (-1 * jac3_2 * jac4_0))
+                    + -1 * jac0_4 * (1 * jac1_0 * (-1 * jac3_2 * jac4_1) + -1 * jac1_1 * (-1 * jac3_2 * jac4_0)));
+    auto com4_2 = 0;
+    auto com0_3
+        = -1
+        * (1 * jac0_1 * (1 * jac1_4 * (-1 * jac2_3 * jac4_2)) + -1 * jac0_4 * (1 * jac1_1 * (-1 * jac2_3 * jac4_2)));
+    auto com1_3
+        = (1 * jac0_0 * (1 * jac1_4 * (-1 * jac2_3 * jac4_2)) + -1 * jac0_4 * (1 * jac1_0 * (-1 * jac2_3 * jac4_2)));
+    auto com2_3 = -1
+                * (1 * jac0_0 * (1 * jac1_1 * (1 * jac2_3 * jac4_4) + 1 * jac1_4 * (-1 * jac2_3 * jac4_1))
+                    + -1 * jac0_1 * (1 * jac1_0 * (1 * jac2_3 * jac4_4) + 1 * jac1_4 * (-1 * jac2_3 * jac4_0))
+                    + -1 * jac0_4 * (1 * jac1_0 * (-1 * jac2_3 * jac4_1) + -1 * jac1_1 * (-1 * jac2_3 * jac4_0)));
+    auto com3_3
+        = (1 * jac0_0
+                * (1 * jac1_1 * (1 * jac2_2 * jac4_4 + -1 * jac2_4 * jac4_2) + 1 * jac1_4 * (-1 * jac2_2 * jac4_1))
+            + -1 * jac0_1
+                  * (1 * jac1_0 * (1 * jac2_2 * jac4_4 + -1 * jac2_4 * jac4_2) + 1 * jac1_4 * (-1 * jac2_2 * jac4_0))
+            + -1 * jac0_4 * (1 * jac1_0 * (-1 * jac2_2 * jac4_1) + -1 * jac1_1 * (-1 * jac2_2 * jac4_0)));
+    auto com4_3
+        = -1
+        * (1 * jac0_0 * (1 * jac1_1 * (-1 * jac2_3 * jac4_2)) + -1 * jac0_1 * (1 * jac1_0 * (-1 * jac2_3 * jac4_2)));
+    auto com0_4
+        = (1 * jac0_1 * (1 * jac1_4 * (-1 * jac2_3 * jac3_2)) + -1 * jac0_4 * (1 * jac1_1 * (-1 * jac2_3 * jac3_2)));
+    auto com1_4
+        = -1
+        * (1 * jac0_0 * (1 * jac1_4 * (-1 * jac2_3 * jac3_2)) + -1 * jac0_4 * (1 * jac1_0 * (-1 * jac2_3 * jac3_2)));
+    auto com2_4 = 0;
+    auto com3_4
+        = -1
+        * (1 * jac0_0 * (1 * jac1_1 * (-1 * jac2_4 * jac3_2)) + -1 * jac0_1 * (1 * jac1_0 * (-1 * jac2_4 * jac3_2)));
+    auto com4_4
+        = (1 * jac0_0 * (1 * jac1_1 * (-1 * jac2_3 * jac3_2)) + -1 * jac0_1 * (1 * jac1_0 * (-1 * jac2_3 * jac3_2)));
+    Eigen::Matrix<DataType, 5, 5> cojacobian(Eigen::Matrix<DataType, 5, 5>::Zero());
+
+    cojacobian << com0_0, com0_1, com0_2, com0_3, com0_4, com1_0, com1_1, com1_2, com1_3, com1_4, com2_0, com2_1,
+        com2_2, com2_3, com2_4, com3_0, com3_1, com3_2, com3_3, com3_4, com4_0, com4_1, com4_2, com4_3, com4_4;
+    Eigen::Matrix<DataType, 5, 1> delta = cojacobian * eqs * invdet;
+
+    // Check if the update is big enough
+    if(delta.hasNaN() || (delta.array().abs() < EPS).all())
+    {
+      return true;
+    }
+
+    // Big variations are only in steady state mode
+    if constexpr(steady_state)
+    {
+      auto max_delta = delta.array().abs().maxCoeff();
+      if(max_delta > MAX_DELTA)
+      {
+        delta *= MAX_DELTA / max_delta;
+      }
+    }
+
+    dynamic -= delta;
+
+    return false;
+  }
+};
+} // namespace Stages
+
+#endif
@@ -0,0 +1,317 @@
+/**
+ * \file 05-dist.h
+ * Generated from 05-dist.cir by ATKModellingGenerator, kernelize.py and templatize.py
+ * The component values are a template parameter, the plugins instantiate the stage with the values of their netlist
+ */
+
+#ifndef STAGES_DIST
+#define STAGES_DIST
+
+#include "Instrumentation.h"
+
+#include <cstdlib>
+#include <memory>
+
+#include <ATK/Core/Utilities.h>
+#include <ATK/Modelling/ModellerFilter.h>
+#include <ATK/Modelling/StaticComponent/StaticCapacitor.h>
+#include <ATK/Modelling/StaticComponent/StaticCoil.h>
+#include <ATK/Modelling/StaticComponent/StaticCurrent.h>
+#include <ATK/Modelling/StaticComponent/StaticDiode.h>
+#include <ATK/Modelling/StaticComponent/StaticEbersMollTransistor.h>
+#include <ATK/Modelling/StaticComponent/StaticMOSFETTransistor.h>
+#include <ATK/Modelling/StaticComponent/StaticResistor.h>
+#include <ATK/Modelling/StaticComponent/StaticResistorCapacitor.h>
+
+#include <Eigen/Eigen>
+
+namespace Stages
+{
+template<typename DataType_, typename Values>
+class DistFilter final
+  : public ATK::ModellerFilter<DataType_>
+#ifdef STAGES_COUNT_ITERATIONS
+  , public IterationCounter
+#endif
+{
+  using Parent = ATK::ModellerFilter<DataType_>;
+  using typename Parent::DataType;
+  using Parent::converted_inputs;
+  using Parent::input_sampling_rate;
+  using Parent::output_sampling_rate;
+  using Parent::outputs;
+
+#ifdef STAGES_TUNABLE_SOLVER
+  static constexpr const gsl::index& MAX_ITERATION = Stages::max_iteration;
+#else
+  static constexpr gsl::index MAX_ITERATION = 10;
+#endif
+  static constexpr gsl::index MAX_ITERATION_STEADY_STATE{200};
+  static constexpr gsl::index INIT_WARMUP{10};
+#ifdef STAGES_TUNABLE_SOLVER
+  static constexpr const double& EPS = Stages::eps;
+#else
+  static constexpr DataType EPS{1e-8};
+#endif
+  static constexpr DataType MAX_DELTA{1e-1};
+
+  bool initialized{false};
+
+  Eigen::Matrix<DataType, 1, 1> static_state{Eigen::Matrix<DataType, 1, 1>::Zero()};
+  mutable Eigen::Matrix<DataType, 1, 1> input_state{Eigen::Matrix<DataType, 1, 1>::Zero()};
+  mutable Eigen::Matrix<DataType, 2, 1> dynamic_state{Eigen::Matrix<DataType, 2, 1>::Zero()};
+  ATK::StaticDiode<DataType, 1, 1> d004d003{Values::d004d003[0], Values::d004d003[1], Values::d004d003[2]};
+  ATK::StaticResistorCapacitor<DataType> r033c027{Values::r033c027[0], Values::r033c027[1]};
+  ATK::StaticResistorCapacitor<DataType> r031c023{Values::r031c023[0], Values::r031c023[1]};
+  ATK::StaticResistor<DataType> r032{Values::r032[0]};
+
+public:
+  DistFilter(): Parent(2, 1)
+  {
+    static_state << 0.000000;
+  }
+
+  ~DistFilter() override = default;
+
+  gsl::index get_nb_dynamic_pins() const override
+  {
+    return 2;
+  }
+
+  gsl::index get_nb_input_pins() const override
+  {
+    return 1;
+  }
+
+  gsl::index get_nb_static_pins() const override
+  {
+    return 1;
+  }
+
+  Eigen::Matrix<DataType, Eigen::Dynamic, 1> get_static_state() const override
+  {
+    return static_state;
+  }
+
+  gsl::index get_nb_components() const override
+  {
+    return 4;
+  }
+
+  std::string get_dynamic_pin_name(gsl::index identifier) const override
+  {
+    switch(identifier)
+    {
+    case 1:
+      return "vout";
+    case 0:
+      return "2";
+    default:
+      throw ATK::RuntimeError("No such pin");
+    }
+  }
+
+  std::string get_input_pin_name(gsl::index identifier) const override
+  {
+    switch(identifier)
+    {
+    case 0:
+      return "vin";
+    default:
+      throw ATK::RuntimeError("No such pin");
+    }
+  }
+
+  std::string get_static_pin_name(gsl::index identifier) const override
+  {
+    switch(identifier)
+    {
+    case 0:
+      return "0";
+    default:
+      throw ATK::RuntimeError("No such pin");
+    }
+  }
+
+  gsl::index get_number_parameters() const override
+  {
+    return 0;
+  }
+
+  std::string get_parameter_name(gsl::index identifier) const override
+  {
+    switch(identifier)
+    {
+    default:
+      throw ATK::RuntimeError("No such pin");
+    }
+  }
+
+  DataType get_parameter(gsl::index identifier) const override
+  {
+    switch(identifier)
+    {
+    default:
+      throw ATK::RuntimeError("No such pin");
+    }
+  }
+
+  void set_parameter(gsl::index identifier, DataType value) override
+  {
+    switch(identifier)
+    {
+    default:
+      throw ATK::RuntimeError("No such pin");
+    }
+  }
+
+  /// Setup the inner state of the filter, slowly incrementing the static state
+  void setup() override
+  {
+    assert(input_sampling_rate == output_sampling_rate);
+
+    if(!initialized)
+    {
+      setup_inverse<true>();
+      auto target_static_state = static_state;
+
+      for(gsl::index i = 0; i < INIT_WARMUP; ++i)
+      {
+        static_state = target_static_state * static_cast<DataType>((i + 1.) / INIT_WARMUP);
+        init();
+      }
+      static_state = target_static_state;
+    }
+    setup_inverse<false>();
+  }
+
+  template <bool steady_state>
+  void setup_inverse()
+  {
+  }
+
+  void init()
+  {
+    // update_steady_state
+    r033c027.update_steady_state(1. / input_sampling_rate, input_state[0], dynamic_state[0]);
+    r031c023.update_steady_state(1. / input_sampling_rate, dynamic_state[1], static_state[0]);
+
+    solve<true>(input_state, dynamic_state);
+
+    // update_steady_state
+    r033c027.update_steady_state(1. / input_sampling_rate, input_state[0], dynamic_state[0]);
+    r031c023.update_steady_state(1. / input_sampling_rate, dynamic_state[1], static_state[0]);
+
+    initialized = true;
+  }
+
+  void process_impl(gsl::index size) const override
+  {
+    // The states are kept in locals for the whole block, so that they can stay in registers
+    const DataType* ATK_RESTRICT input0 = converted_inputs[0];
+    DataType* ATK_RESTRICT output0 = outputs[0];
+    DataType* ATK_RESTRICT output1 = outputs[1];
+    Eigen::Matrix<DataType, 1, 1> input = input_state;
+    Eigen::Matrix<DataType, 2, 1> dynamic = dynamic_state;
+
+    for(gsl::index i = 0; i < size; ++i)
+    {
+      input[0] = input0[i];
+
+      solve<false>(input, dynamic);
+
+      // Update state
+      r033c027.update_state(input[0], dynamic[0]);
+      r031c023.update_state(dynamic[1], static_state[0]);
+      output0[i] = dynamic[0];
+      output1[i] = dynamic[1];
+    }
+
+    input_state = input;
+    dynamic_state = dynamic;
+  }
+
+  /// Solve for steady state and non steady state the system
+  template <bool steady_state>
+  void solve(const Eigen::Matrix<DataType, 1, 1>& input, Eigen::Matrix<DataType, 2, 1>& dynamic) const
+  {
+    gsl::index iteration = 0;
+
+    const gsl::index current_max_iter = steady_state ? MAX_ITERATION_STEADY_STATE : MAX_ITERATION;
+
+    while(iteration < current_max_iter && !iterate<steady_state>(input, dynamic))
+    {
+      ++iteration;
+    }
+  }
+
+  template <bool steady_state>
+  bool iterate(const Eigen::Matrix<DataType, 1, 1>& input, Eigen::Matrix<DataType, 2, 1>& dynamic) const
+  {
+#ifdef STAGES_COUNT_ITERATIONS
+    ++nb_iterations;
+#endif
+    // Static states
+    auto s0_ = static_state[0];
+
+    // Input states
+    auto i0_ = input[0];
+
+    // Dynamic states
+    auto d0_ = dynamic[0];
+    auto d1_ = dynamic[1];
+
+    // Precomputes
+    d004d003.precompute(dynamic[0], static_state[0]);
+
+    Eigen::Matrix<DataType, 2, 1> eqs(Eigen::Matrix<DataType, 2, 1>::Zero());
+    auto eq0
+        = +d004d003.get_current() - (steady_state ? 0 : r033c027.get_current(i0_, d0_)) + r032.get_current(d0_, d1_);
+    auto eq1 = +(steady_state ? 0 : r031c023.get_current(d1_, s0_)) - r032.get_current(d0_, d1_);
+    eqs << eq0, eq1;
+
+    // Check if the equations have converged
+    if((eqs.array().abs() < EPS).all())
+    {
+      return true;
+    }
+
+    auto jac0_0 = 0 - d004d003.get_gradient() - (steady_state ? 0 : r033c027.get_gradient()) - r032.get_gradient();
+    auto jac0_1 = 0 + r032.get_gradient();
+    auto jac1_0 = 0 + r032.get_gradient();
+    auto jac1_1 = 0 - (steady_state ? 0 : r031c023.get_gradient()) - r032.get_gradient();
+    auto det = (1 * jac0_0 * jac1_1 + -1 * jac0_1 * jac1_0);
+    auto invdet = 1 / det;
+    auto com0_0 = jac1_1;
+    auto com1_0 = -1 * jac1_0;
+    auto com0_1 = -1 * jac0_1;
+    auto com1_1 = jac0_0;
+    Eigen::Matrix<DataType, 2, 2> cojacobian(Eigen::Matrix<DataType, 2, 2>::Zero());
+
+    cojacobian << com0_0, com0_1, com1_0, com1_1;
+    Eigen::Matrix<DataType, 2, 1> delta = cojacobian * eqs * invdet;
+
+    // Check if the update is big enough
+    if(delta.hasNaN() || (delta.array().abs() < EPS).all())
+    {
+      return true;
+    }
+
+    // Big variations are only in steady state mode
+    if constexpr(steady_state)
+    {
+      auto max_delta = delta.array().abs().maxCoeff();
+      if(max_delta > MAX_DELTA)
+      {
+        delta *= MAX_DELTA / max_delta;
+      }
+    }
+
+    dynamic -= delta;
+
+    return false;
+  }
+};
+} // namespace Stages
+
+#endif
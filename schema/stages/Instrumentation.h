@@ -0,0 +1,60 @@
+/**
+ * \file Instrumentation.h
+ */
+
+#ifndef STAGES_INSTRUMENTATION
+#define STAGES_INSTRUMENTATION
+
+#include <ATK/Core/BaseFilter.h>
+#include <ATK/Core/Utilities.h>
+
+#include <cstdint>
+
+namespace Stages
+{
+#ifdef STAGES_COUNT_ITERATIONS
+/// Newton iterations of a stage, only counted in the tools and builds that define STAGES_COUNT_ITERATIONS
+/**
+ * Each stage has its own counter, only written by the thread processing it, so that stages of different chains or
+ * plugin instances don't share any state.
+ */
+class IterationCounter
+{
+public:
+  virtual ~IterationCounter() = default;
+
+  /// Returns the Newton iterations of the stage since it was created
+  std::int64_t get_nb_iterations() const
+  {
+    return nb_iterations;
+  }
+
+protected:
+  mutable std::int64_t nb_iterations{0};
+};
+
+/// Returns the counter of filter, nullptr for the filters that don't iterate
+inline const IterationCounter* get_iteration_counter(const ATK::BaseFilter* filter)
+{
+  return dynamic_cast<const IterationCounter*>(filter);
+}
+
+/// Returns the Newton iterations of filter since it was created, 0 for the filters that don't iterate
+inline std::int64_t get_nb_iterations(const ATK::BaseFilter& filter)
+{
+  const IterationCounter* counter = get_iteration_counter(&filter);
+  return counter ? counter->get_nb_iterations() : 0;
+}
+#endif
+
+#ifdef STAGES_TUNABLE_SOLVER
+/// Newton settings of the nonlinear stages, only variables in the tools that define STAGES_TUNABLE_SOLVER
+/**
+ * The stages otherwise use the constants of ATKModellingGenerator, 10 iterations and a tolerance of 1e-8.
+ */
+inline gsl::index max_iteration{10};
+inline double eps{1e-8};
+#endif
+} // namespace Stages
+
+#endif
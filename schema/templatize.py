@@ -0,0 +1,146 @@
+#!/usr/bin/python3
+
+# USAGE:
+# templatize.py stage.cpp header.h
+# templatize.py stage.cpp header.h namespace source.cpp
+#
+# Turns a stage generated by ATKModellingGenerator (and kernelize.py) into a class template shared by the plugins.
+#
+# The first form writes header.h, a template on the scalar type and on a table of component values. The second
+# form checks that header.h is the template of stage.cpp, i.e. that both netlists only differ by their values,
+# and writes source.cpp, the table of values of stage.cpp and the createStaticFilter_stageN() of the plugin in
+# namespace. MT2 and MTB then share the stage code, and only their values are duplicated.
+
+import os
+import re
+import sys
+
+COMPONENT = re.compile(r"^  ATK::(Static\w+)<DataType((?:, \d+)*)> (\w+)\{(.*?)\};\n", re.MULTILINE | re.DOTALL)
+
+def class_name(filename):
+  "01-high-pass.cpp -> HighPassFilter"
+  stem = os.path.splitext(os.path.basename(filename))[0]
+  return "".join(word.capitalize() for word in stem.split("-")[1:]) + "Filter"
+
+def stage_number(filename):
+  return int(os.path.basename(filename).split("-")[0])
+
+def components(source):
+  "Names and values of the components, in the order of the class"
+  return [(match.group(3), [value.strip() for value in match.group(4).split(",") if value.strip()])
+          for match in COMPONENT.finditer(source)]
+
+def normalize(source):
+  "Older versions of ATKModellingGenerator don't make the filter final and don't declare its destructor"
+  source = source.replace("class StaticFilter: public", "class StaticFilter final: public")
+  if "~StaticFilter()" not in source:
+    source = source.replace("  }\n\n  gsl::index get_nb_dynamic_pins()",
+                            "  }\n\n  ~StaticFilter() override = default;\n\n  gsl::index get_nb_dynamic_pins()", 1)
+  return source
+
+def template(source, filename):
+  name = class_name(filename)
+  source = normalize(source)
+  body = source[source.index("namespace\n{\n") + len("namespace\n{\n"):source.index("} // namespace\n")]
+  constants = body[:body.index("class StaticFilter")]
+  body = body[len(constants):]
+
+  # The constants become members, in the scalar type for those that are compared with the states
+  # The Newton settings of the nonlinear stages can be swept by the tools, the linear stages are solved in one step
+  nonlinear = "constexpr gsl::index MAX_ITERATION{1};" not in constants
+  tunable = {"MAX_ITERATION": "  static constexpr const gsl::index& MAX_ITERATION = Stages::max_iteration;",
+             "EPS": "  static constexpr const double& EPS = Stages::eps;"}
+  members = []
+  for line in constants.strip().split("\n"):
+    if line:
+      member = "  static " + line.replace("constexpr double", "constexpr DataType")
+      constant = re.match(r"constexpr \w+(?:::\w+)? (\w+)", line).group(1)
+      if nonlinear and constant in tunable:
+        member = "#ifdef STAGES_TUNABLE_SOLVER\n%s\n#else\n%s\n#endif" % (tunable[constant], member)
+      members.append(member)
+
+  body = body.replace(
+      "class StaticFilter final: public ATK::ModellerFilter<double>\n{\n  using typename ATK::TypedBaseFilter<double>::DataType;\n",
+      "template<typename DataType_, typename Values>\nclass %s final\n  : public ATK::ModellerFilter<DataType_>\n"
+      "#ifdef STAGES_COUNT_ITERATIONS\n  , public IterationCounter\n#endif\n{\n"
+      "  using Parent = ATK::ModellerFilter<DataType_>;\n"
+      "  using typename Parent::DataType;\n"
+      "  using Parent::converted_inputs;\n"
+      "  using Parent::input_sampling_rate;\n"
+      "  using Parent::output_sampling_rate;\n"
+      "  using Parent::outputs;\n\n%s\n\n" % (name, "\n".join(members)))
+  body = body.replace("  StaticFilter(): ModellerFilter<DataType>(", "  %s(): Parent(" % name)
+  body = body.replace("  ~StaticFilter()", "  ~%s()" % name)
+  body = body.replace("((i + 1.) / INIT_WARMUP)", "static_cast<DataType>((i + 1.) / INIT_WARMUP)")
+  body = body.replace("constexpr int current_max_iter =", "const gsl::index current_max_iter =")
+
+  def component(match):
+    kind, extra, component_name, values = match.groups()
+    arguments = ", ".join("Values::%s[%d]" % (component_name, i) for i in range(len(components(match.group(0))[0][1])))
+    return "  ATK::%s<DataType%s> %s{%s};\n" % (kind, extra, component_name, arguments)
+  body = COMPONENT.sub(component, body)
+  iterate = re.search(r"  bool iterate\(.*\) const\n  \{\n", body).end()
+  body = body[:iterate] + "#ifdef STAGES_COUNT_ITERATIONS\n    ++nb_iterations;\n#endif\n" + body[iterate:]
+
+  includes = '#include "Instrumentation.h"\n\n' + source[:source.index("namespace\n{\n")].rstrip("\n")
+  guard = "STAGES_" + re.sub(r"\W", "_", os.path.splitext(os.path.basename(filename))[0].split("-", 1)[1]).upper()
+  return """/**
+ * \\file %s
+ * Generated from %s.cir by ATKModellingGenerator, kernelize.py and templatize.py
+ * The component values are a template parameter, the plugins instantiate the stage with the values of their netlist
+ */
+
+#ifndef %s
+#define %s
+
+%s
+
+namespace Stages
+{
+%s} // namespace Stages
+
+#endif
+""" % (os.path.splitext(os.path.basename(filename))[0] + ".h", os.path.splitext(os.path.basename(filename))[0],
+       guard, guard, includes, body)
+
+def instantiation(source, filename, header, namespace):
+  name = class_name(filename)
+  values = name[:-len("Filter")] + "Values"
+  schema = os.path.basename(os.path.dirname(os.path.abspath(filename)))
+  table = "\n".join("  static constexpr double %s[] = {%s};" % (component, ", ".join(component_values))
+                    for component, component_values in components(source))
+  return """#include "static_elements.h"
+
+#include "%s"
+
+namespace %s
+{
+namespace
+{
+/// Component values of %s/%s.cir
+struct %s
+{
+%s
+};
+} // namespace
+
+std::unique_ptr<ATK::ModellerFilter<double>> createStaticFilter_stage%d()
+{
+  return std::make_unique<Stages::%s<double, %s>>();
+}
+} // namespace %s
+""" % (os.path.basename(header), namespace, schema, os.path.splitext(os.path.basename(filename))[0], values, table,
+       stage_number(filename), name, values, namespace)
+
+if __name__ == "__main__":
+  filename, header = sys.argv[1], sys.argv[2]
+  source = open(filename).read()
+  generated = template(source, filename)
+  if len(sys.argv) == 3:
+    with open(header, "w") as output:
+      output.write(generated)
+  else:
+    if open(header).read() != generated:
+      sys.exit("%s is not the template of %s, the netlists differ by more than their values" % (header, filename))
+    with open(sys.argv[4], "w") as output:
+      output.write(instantiation(source, filename, header, sys.argv[3]))
@@ -1,10 +1,11 @@
+#include "CharacterizationFile.h"
+
 #include <ATK/Core/InPointerFilter.h>
 #include <ATK/Core/OutPointerFilter.h>
 #include <ATK/EQ/SecondOrderSVFFilter.h>
 
 #include <boost/math/constants/constants.hpp>
 
-#include <fstream>
 #include <memory>
 #include <vector>
 
@@ -44,9 +45,5 @@ int main(int argc, const char** argv)
     outFilter.process(1024);
   }
 
-  std::ofstream out(argv[1]);
-  for(size_t i = 0; i < PROCESSSIZE; ++i)
-  {
-    out << input[i] << "\t" << output[i] << std::endl;
-  }
+  write_characterization(argv[1], SAMPLING_RATE, input, output);
 }
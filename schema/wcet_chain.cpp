@@ -0,0 +1,182 @@
+#include "ProcessingChain.h"
+#include "stages/Instrumentation.h"
+
+#include <boost/math/constants/constants.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef STAGES_COUNT_ITERATIONS
+#error "The stages must be compiled with STAGES_COUNT_ITERATIONS"
+#endif
+
+// PLUGIN is the namespace of the chain, MT2 or MTB, and MID_FREQ its default mid frequency, both set by the Makefile
+#define STRINGIFY_(x) #x
+#define STRINGIFY(x) STRINGIFY_(x)
+
+namespace
+{
+constexpr long SAMPLING_RATE = 48000;
+constexpr double DURATION = 20;
+
+struct Block
+{
+  double time;
+  std::int64_t iterations;
+  float distLevel;
+};
+
+/// Adversarial input of a scenario, and the distLevel of each block
+struct Scenario
+{
+  std::string name;
+  std::vector<float> input;
+  std::vector<float> distLevels;
+};
+
+/// Full scale 110 Hz square bursts of 50 ms, with gaps long enough for the chain to go idle and wake up on an edge
+Scenario make_square_bursts(int block_size)
+{
+  Scenario scenario{"square-bursts", std::vector<float>(static_cast<size_t>(SAMPLING_RATE * DURATION)), {}};
+  for(size_t i = 0; i < scenario.input.size(); ++i)
+  {
+    const double t = static_cast<double>(i) / SAMPLING_RATE;
+    const double cycle = std::fmod(t, .4);
+    const bool burst = cycle < .05 || (cycle >= .1 && cycle < .15);
+    scenario.input[i] = burst ? (std::fmod(t * 110, 1.) < .5 ? 1.f : -1.f) : 0.f;
+  }
+  scenario.distLevels.assign(scenario.input.size() / block_size + 1, 100.f);
+  return scenario;
+}
+
+/// Steps between -1, 0 and 1 every 100 ms, the coupling capacitors make each of them a hot transient
+Scenario make_dc_steps(int block_size)
+{
+  constexpr std::array<float, 4> levels{1.f, -1.f, 0.f, 1.f};
+  Scenario scenario{"dc-steps", std::vector<float>(static_cast<size_t>(SAMPLING_RATE * DURATION)), {}};
+  for(size_t i = 0; i < scenario.input.size(); ++i)
+  {
+    scenario.input[i] = levels[(i / (SAMPLING_RATE / 10)) % levels.size()];
+  }
+  scenario.distLevels.assign(scenario.input.size() / block_size + 1, 100.f);
+  return scenario;
+}
+
+/// Full scale chord with distLevel jumping between 0 and 100 at every block
+Scenario make_dist_automation(int block_size)
+{
+  constexpr double pi = boost::math::constants::pi<double>();
+  Scenario scenario{"dist-automation", std::vector<float>(static_cast<size_t>(SAMPLING_RATE * DURATION)), {}};
+  for(size_t i = 0; i < scenario.input.size(); ++i)
+  {
+    const double t = static_cast<double>(i) / SAMPLING_RATE;
+    scenario.input[i] = static_cast<float>(
+        (std::sin(2 * pi * 82.41 * t) + std::sin(2 * pi * 123.47 * t) + std::sin(2 * pi * 164.81 * t)) / 3);
+  }
+  for(size_t i = 0; i < scenario.input.size() / block_size + 1; ++i)
+  {
+    scenario.distLevels.push_back(i % 2 ? 100.f : 0.f);
+  }
+  return scenario;
+}
+
+std::vector<Block> run(const Scenario& scenario, int block_size, PLUGIN::ProcessingChain::Model model)
+{
+  PLUGIN::ProcessingChain chain;
+  chain.configure(SAMPLING_RATE, block_size, PLUGIN::ProcessingChain::Resampling::MinimumPhase, model);
+  PLUGIN::ProcessingChain::Parameters parameters{50.f, 0.f, 0.f, 0.f, MID_FREQ, 3.1f, .25f, 1.f};
+
+  std::vector<float> output(block_size);
+  std::vector<Block> blocks;
+  blocks.reserve(scenario.input.size() / block_size);
+  for(size_t i = 0; i + block_size <= scenario.input.size(); i += block_size)
+  {
+    parameters.distLevel = scenario.distLevels[i / block_size];
+    const std::int64_t start_iterations = chain.getNbIterations();
+    const auto start = std::chrono::steady_clock::now();
+    chain.setParameters(parameters);
+    chain.process(scenario.input.data() + i, output.data(), block_size);
+    const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    blocks.push_back({elapsed.count(), chain.getNbIterations() - start_iterations, parameters.distLevel});
+  }
+  return blocks;
+}
+} // namespace
+
+/// Measures the worst block times of the chain on adversarial material
+/**
+ * Usage: wcet_chain.exe prefix [block_size]
+ * Each scenario runs at 48 kHz for 20 s, in blocks of 64 samples by default, with the Full and the Eco models.
+ * prefix.csv gets the time and the Newton iterations of every block, for the distributions. prefix.txt gets the
+ * percentiles, the number of blocks over their deadline and, for each scenario, the worst block with its input. The
+ * scenarios are deterministic, so the worst block is reproduced by running its scenario up to its index.
+ */
+int main(int argc, const char** argv)
+{
+  const std::string prefix = argv[1];
+  const int block_size = argc > 2 ? std::atoi(argv[2]) : 64;
+  const double deadline = block_size * 1e6 / SAMPLING_RATE;
+
+  std::ofstream blocks_out(prefix + ".csv");
+  blocks_out << "plugin,scenario,model,block,time_us,iterations,dist_level" << std::endl;
+  std::ofstream report(prefix + ".txt");
+  report << STRINGIFY(PLUGIN) << " at " << SAMPLING_RATE << " Hz, blocks of " << block_size << " samples, deadline "
+         << deadline << " us" << std::endl;
+
+  for(const auto& scenario :
+      {make_square_bursts(block_size), make_dc_steps(block_size), make_dist_automation(block_size)})
+  {
+    for(auto model : {PLUGIN::ProcessingChain::Model::Full, PLUGIN::ProcessingChain::Model::Eco})
+    {
+      const char* model_name = model == PLUGIN::ProcessingChain::Model::Full ? "Full" : "Eco";
+      const std::vector<Block> blocks = run(scenario, block_size, model);
+
+      std::vector<double> times;
+      size_t worst = 0;
+      size_t overruns = 0;
+      for(size_t i = 0; i < blocks.size(); ++i)
+      {
+        blocks_out << STRINGIFY(PLUGIN) << "," << scenario.name << "," << model_name << "," << i << ","
+                   << blocks[i].time << "," << blocks[i].iterations << "," << blocks[i].distLevel << std::endl;
+        times.push_back(blocks[i].time);
+        if(blocks[i].time > blocks[worst].time)
+        {
+          worst = i;
+        }
+        if(blocks[i].time > deadline)
+        {
+          ++overruns;
+        }
+      }
+      std::sort(times.begin(), times.end());
+
+      report << std::endl << scenario.name << ", " << model_name << std::endl;
+      for(double fraction : {.5, .99, .999})
+      {
+        report << "  p" << fraction * 100 << ": "
+               << times[std::min(times.size() - 1, static_cast<size_t>(fraction * times.size()))] << " us"
+               << std::endl;
+      }
+      report << "  max: " << times.back() << " us, jitter (max - p50): "
+             << times.back() - times[times.size() / 2] << " us" << std::endl;
+      report << "  blocks over the deadline: " << overruns << " / " << blocks.size() << std::endl;
+      report << "  worst block: " << worst << " (sample " << worst * block_size << "), "
+             << blocks[worst].iterations << " iterations, distLevel " << blocks[worst].distLevel << ", input:";
+      for(int i = 0; i < block_size; ++i)
+      {
+        report << " " << scenario.input[worst * block_size + i];
+      }
+      report << std::endl;
+      std::cout << scenario.name << ", " << model_name << ": max " << times.back() << " us, " << overruns
+                << " overruns" << std::endl;
+    }
+  }
+}